@@ -0,0 +1,696 @@
+// 网格构建微基准。先跑场景套件：几个固定种子的生成地形与人为构造的最坏情况
+// （三维棋盘格、全水、满地植物、三维噪声洞穴），报告每个场景的 chunks/s、每 chunk 的四边形数与
+// 顶点字节数、单次构建延迟的 p50/p99，可用 --json 写成 JSON 以便前后两次运行对比。
+// 之后在 TerrainGenerator 生成的真实地形上，对比逐体素 mask 的参考贪心实现
+// 与基于 64 位列掩码的二进制贪心实现的单 chunk 构建耗时，并校验两者输出完全一致；
+// 另外测量在地表放置一个方块后只重建脏分段（含拍快照）与整 chunk 重建的耗时，
+// 校验相邻 chunk 以任意 LOD 组合构建时接缝处没有漏缝，
+// 以及各 LOD 级别网格的四边形数与按 World 的 LOD 半径估算的整个视距的四边形总数；
+// 最后用替换的全局 operator new 统计复用输出时每次构建的堆分配次数（稳态应为 0）。
+//
+// 用法：mycraft_mesh_bench [--json FILE] [--mesher binary|reference] [--suite-only]
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "chunk.h"
+#include "chunk_mesher.h"
+#include "terrain_generator.h"
+
+namespace {
+std::atomic<std::size_t> heapAllocations{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++heapAllocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSeed = 12345;
+constexpr int kWaterLevel = 32;
+constexpr int kRadius = 4; // 生成 (2r+1)^2 个 chunk，只对内圈 (2r-1)^2 个构建（保证邻居齐全）
+constexpr int kRepeats = 5;
+constexpr int kSuiteRepeats = 20;                            // 套件中每个 chunk 计时构建的次数（另有一次预热）
+constexpr int kSuiteSeeds[] = {12345, 20240601, -918273645}; // 套件中生成地形的种子
+
+struct Result {
+    double msPerChunk = 0.0;
+    std::size_t quads = 0;
+    std::vector<ChunkMeshData> meshes;
+};
+
+Result run(const std::vector<std::unique_ptr<MeshInput>>& inputs, const BlockRegistry& registry, GreedyMesher mesher) {
+    Result result;
+    double best = 0.0;
+    for (int rep = 0; rep < kRepeats; ++rep) {
+        std::vector<ChunkMeshData> meshes;
+        meshes.reserve(inputs.size());
+        auto start = Clock::now();
+        for (const auto& input : inputs) {
+            meshes.push_back(buildChunkMesh(*input, registry, mesher));
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (rep == 0 || ms < best) {
+            best = ms;
+        }
+        result.meshes = std::move(meshes);
+    }
+    result.msPerChunk = best / static_cast<double>(inputs.size());
+    for (const ChunkMeshData& mesh : result.meshes) {
+        for (const SectionMeshData& section : mesh.sectionMeshes) {
+            // 植物实例按其绘制出的四边形计，和改为实例化之前的数字可比
+            result.quads += (section.solidVertices.size() + section.alphaVertices.size() + section.liquidVertices.size()) / 4 +
+                            section.billboards.size() * kBillboardQuads;
+        }
+    }
+    return result;
+}
+
+bool sameVertices(const std::vector<ChunkVertex>& a, const std::vector<ChunkVertex>& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](const ChunkVertex& x, const ChunkVertex& y) {
+               return x.position == y.position && x.surface == y.surface && x.color == y.color;
+           });
+}
+
+// 不透明顶点须按 solidFaceQuads 分成 6 段，每段内顶点的 face 字段都等于该段的方向
+bool faceRangesMatch(const SectionMeshData& section) {
+    std::size_t vertex = 0;
+    for (std::uint32_t face = 0; face < 6; ++face) {
+        const std::size_t end = vertex + std::size_t{section.solidFaceQuads[face]} * 4;
+        if (end > section.solidVertices.size()) {
+            return false;
+        }
+        for (; vertex < end; ++vertex) {
+            if (((section.solidVertices[vertex].surface >> 15) & 7u) != face) {
+                return false;
+            }
+        }
+    }
+    return vertex == section.solidVertices.size();
+}
+
+bool sameSection(const SectionMeshData& a, const SectionMeshData& b) {
+    return a.solidFaceQuads == b.solidFaceQuads && faceRangesMatch(a) &&
+           sameVertices(a.solidVertices, b.solidVertices) && sameVertices(a.alphaVertices, b.alphaVertices) &&
+           sameVertices(a.liquidVertices, b.liquidVertices) &&
+           sameVertices(a.billboards, b.billboards);
+}
+
+bool sameMesh(const ChunkMeshData& a, const ChunkMeshData& b) {
+    if (a.sections != b.sections || a.minY != b.minY || a.maxY != b.maxY) {
+        return false;
+    }
+    for (std::size_t s = 0; s < a.sectionMeshes.size(); ++s) {
+        if (!sameSection(a.sectionMeshes[s], b.sectionMeshes[s])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 快照 + 构建的最短耗时（毫秒）
+double timeRebuild(const Chunk& chunk, const BlockRegistry& registry, Chunk::SectionMask sections, ChunkMeshData& mesh) {
+    double best = 0.0;
+    for (int rep = 0; rep < kRepeats; ++rep) {
+        auto start = Clock::now();
+        MeshInput input(chunk, sections);
+        mesh = buildChunkMesh(input, registry);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (rep == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+// 场景套件 ------------------------------------------------------------------
+
+// 一个场景：(2r+1)^2 个按同一规则填充的 chunk，只构建邻居齐全的内圈 (2r-1)^2 个
+struct Scenario {
+    std::string name;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<std::unique_ptr<MeshInput>> inputs;
+};
+
+struct ScenarioResult {
+    std::string name;
+    std::size_t chunks = 0;
+    std::size_t builds = 0;
+    double chunksPerSecond = 0.0;
+    double quadsPerChunk = 0.0;
+    double bytesPerChunk = 0.0; // 上传的顶点与植物实例字节数
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+};
+
+Scenario makeScenario(std::string name, const BlockRegistry& registry, int radius, const std::function<void(Chunk&)>& fill) {
+    Scenario scenario;
+    scenario.name = std::move(name);
+    const int side = 2 * radius + 1;
+    for (int cz = -radius; cz <= radius; ++cz) {
+        for (int cx = -radius; cx <= radius; ++cx) {
+            auto chunk = std::make_unique<Chunk>(ChunkCoord{cx, cz}, registry);
+            fill(*chunk);
+            scenario.chunks.push_back(std::move(chunk));
+        }
+    }
+    auto at = [&](int cx, int cz) -> Chunk* {
+        if (cx < -radius || cx > radius || cz < -radius || cz > radius) {
+            return nullptr;
+        }
+        return scenario.chunks[static_cast<std::size_t>((cz + radius) * side + (cx + radius))].get();
+    };
+    for (int cz = -radius + 1; cz < radius; ++cz) {
+        for (int cx = -radius + 1; cx < radius; ++cx) {
+            Chunk* chunk = at(cx, cz);
+            for (int dz = -1; dz <= 1; ++dz) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx != 0 || dz != 0) {
+                        chunk->setNeighbor(dx, dz, at(cx + dx, cz + dz));
+                    }
+                }
+            }
+            scenario.inputs.push_back(std::make_unique<MeshInput>(*chunk));
+        }
+    }
+    return scenario;
+}
+
+// 按世界坐标逐体素填充 chunk
+void fillVoxels(Chunk& chunk, const std::function<BlockId(int, int, int)>& blockAt) {
+    const glm::ivec3 origin = chunk.worldOrigin();
+    for (int y = 0; y < Chunk::HEIGHT; ++y) {
+        for (int z = 0; z < Chunk::SIZE; ++z) {
+            for (int x = 0; x < Chunk::SIZE; ++x) {
+                const BlockId id = blockAt(origin.x + x, y, origin.z + z);
+                if (id != BlockId::Air) {
+                    chunk.setBlock(x, y, z, id);
+                }
+            }
+        }
+    }
+}
+
+std::uint32_t hash3(int x, int y, int z) {
+    std::uint32_t h = static_cast<std::uint32_t>(x) * 0x8da6b343u ^ static_cast<std::uint32_t>(y) * 0xd8163841u ^
+                      static_cast<std::uint32_t>(z) * 0xcb1ab31fu;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return h ^ (h >> 15);
+}
+
+// 三线性插值的格点值噪声，取值 [0, 1]；不依赖 glm::perlin，各平台结果一致
+float valueNoise(float x, float y, float z) {
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const int z0 = static_cast<int>(std::floor(z));
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+    const float fz = z - static_cast<float>(z0);
+    auto corner = [&](int dx, int dy, int dz) {
+        return static_cast<float>(hash3(x0 + dx, y0 + dy, z0 + dz) & 0xFFFFu) / 65535.0f;
+    };
+    auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+    const float x00 = lerp(corner(0, 0, 0), corner(1, 0, 0), fx);
+    const float x10 = lerp(corner(0, 1, 0), corner(1, 1, 0), fx);
+    const float x01 = lerp(corner(0, 0, 1), corner(1, 0, 1), fx);
+    const float x11 = lerp(corner(0, 1, 1), corner(1, 1, 1), fx);
+    return lerp(lerp(x00, x10, fy), lerp(x01, x11, fy), fz);
+}
+
+BlockId caveBlock(int x, int y, int z) {
+    if (y >= Chunk::HEIGHT - 8) return BlockId::Air;
+    const float n = valueNoise(static_cast<float>(x) * 0.11f, static_cast<float>(y) * 0.14f, static_cast<float>(z) * 0.11f) * 0.7f +
+                    valueNoise(static_cast<float>(x) * 0.31f, static_cast<float>(y) * 0.35f, static_cast<float>(z) * 0.31f) * 0.3f;
+    return y == 0 || n > 0.45f ? BlockId::Stone : BlockId::Air;
+}
+
+std::vector<Scenario> makeScenarios(const BlockRegistry& registry) {
+    std::vector<Scenario> scenarios;
+    for (int seed : kSuiteSeeds) {
+        const TerrainGenerator terrain(seed, kWaterLevel);
+        scenarios.push_back(makeScenario("terrain_" + std::to_string(seed), registry, kRadius,
+                                         [&](Chunk& chunk) { terrain.generate(chunk); }));
+    }
+    // 相邻方块全不相同：每个实心方块 6 个面都可见且无法合并
+    scenarios.push_back(makeScenario("checkerboard", registry, 2, [](Chunk& chunk) {
+        fillVoxels(chunk, [](int x, int y, int z) { return ((x + y + z) & 1) == 0 ? BlockId::Stone : BlockId::Air; });
+    }));
+    // 整 chunk 的水：同种液体之间的面被剔除，只剩 chunk 顶面（两侧邻居也是水）
+    scenarios.push_back(makeScenario("all_water", registry, 2, [](Chunk& chunk) {
+        fillVoxels(chunk, [](int, int, int) { return BlockId::Water; });
+    }));
+    // 草地上每一列都长着植物
+    scenarios.push_back(makeScenario("dense_flowers", registry, 2, [](Chunk& chunk) {
+        constexpr int kGround = kWaterLevel + 8;
+        fillVoxels(chunk, [](int x, int y, int z) {
+            if (y < kGround - 3) return BlockId::Stone;
+            if (y < kGround) return BlockId::Dirt;
+            if (y == kGround) return BlockId::Grass;
+            if (y == kGround + 1) {
+                const int plant = static_cast<int>(hash3(x, y, z) % 14u);
+                return plant == 0 ? BlockId::TallGrass : static_cast<BlockId>(static_cast<int>(BlockId::Flower) + (plant - 1) % 4);
+            }
+            return BlockId::Air;
+        });
+    }));
+    // 三维噪声挖出的洞穴：大量不规则的内部表面与 AO
+    scenarios.push_back(makeScenario("noise_cave", registry, 2, [](Chunk& chunk) { fillVoxels(chunk, caveBlock); }));
+    return scenarios;
+}
+
+// 会重排 samples（nth_element），多次调用结果仍正确
+double percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const std::size_t rank = std::min(samples.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+    return samples[rank];
+}
+
+// 像 World 那样把输出交回复用，先预热一遍（临时缓冲长到峰值、统计四边形），再逐次计时
+ScenarioResult runScenario(const Scenario& scenario, const BlockRegistry& registry, GreedyMesher mesher) {
+    ScenarioResult result;
+    result.name = scenario.name;
+    result.chunks = scenario.inputs.size();
+    std::array<ChunkMeshData, 4> outputs;
+    std::size_t quads = 0;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < scenario.inputs.size(); ++i) {
+        ChunkMeshData& out = outputs[i % outputs.size()];
+        buildChunkMesh(*scenario.inputs[i], registry, out, mesher);
+        for (const SectionMeshData& section : out.sectionMeshes) {
+            const std::size_t vertices = section.solidVertices.size() + section.alphaVertices.size() + section.liquidVertices.size();
+            quads += vertices / 4 + section.billboards.size() * kBillboardQuads;
+            bytes += (vertices + section.billboards.size()) * sizeof(ChunkVertex);
+        }
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(scenario.inputs.size() * kSuiteRepeats);
+    for (int rep = 0; rep < kSuiteRepeats; ++rep) {
+        for (std::size_t i = 0; i < scenario.inputs.size(); ++i) {
+            ChunkMeshData& out = outputs[i % outputs.size()];
+            const Clock::time_point start = Clock::now();
+            buildChunkMesh(*scenario.inputs[i], registry, out, mesher);
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+    }
+    const double totalMs = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+    const double chunks = static_cast<double>(result.chunks);
+    result.builds = latencies.size();
+    result.chunksPerSecond = totalMs > 0.0 ? static_cast<double>(result.builds) * 1000.0 / totalMs : 0.0;
+    result.quadsPerChunk = static_cast<double>(quads) / chunks;
+    result.bytesPerChunk = static_cast<double>(bytes) / chunks;
+    result.p50Ms = percentile(latencies, 0.50);
+    result.p99Ms = percentile(latencies, 0.99);
+    return result;
+}
+
+bool writeJson(const std::string& path, const std::vector<ScenarioResult>& results, const char* mesherName) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << std::fixed << "{\n"
+        << "  \"mesher\": \"" << mesherName << "\",\n"
+        << "  \"chunk_size\": " << Chunk::SIZE << ",\n"
+        << "  \"world_height\": " << Chunk::HEIGHT << ",\n"
+        << "  \"repeats\": " << kSuiteRepeats << ",\n"
+        << "  \"scenarios\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const ScenarioResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"chunks\": " << r.chunks << ", \"builds\": " << r.builds
+            << std::setprecision(1) << ", \"chunks_per_sec\": " << r.chunksPerSecond << ", \"quads_per_chunk\": " << r.quadsPerChunk
+            << ", \"bytes_per_chunk\": " << r.bytesPerChunk << std::setprecision(4) << ", \"p50_ms\": " << r.p50Ms
+            << ", \"p99_ms\": " << r.p99Ms << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+// LOD 接缝检查 ---------------------------------------------------------------
+
+// 体素 (x,y,z) 在按 lod 绘制的 chunk 中是否被填充：LOD 0 为方块本身，
+// 更粗的级别与 extractQuadsLod 的投票一致（所在格子至少一半是非植物方块）
+bool renderedFilled(const Chunk& chunk, const BlockRegistry& registry, int lod, int x, int y, int z) {
+    const int s = 1 << lod;
+    const int x0 = x / s * s;
+    const int y0 = y / s * s;
+    const int z0 = z / s * s;
+    int filled = 0;
+    for (int cy = y0; cy < y0 + s; ++cy) {
+        for (int cz = z0; cz < z0 + s; ++cz) {
+            for (int cx = x0; cx < x0 + s; ++cx) {
+                const BlockId id = chunk.block(cx, cy, cz);
+                filled += id != BlockId::Air && !registry.info(id).billboard ? 1 : 0;
+            }
+        }
+    }
+    return filled * 2 >= s * s * s;
+}
+
+// 把 mesh 中落在 x == planeX（局部坐标，单位为格）、朝向 face 的四边形覆盖的 (y,z) 格子标记到 covered
+void markSeamFaces(const ChunkMeshData& mesh, int face, int planeX, std::vector<bool>& covered) {
+    auto mark = [&](const std::vector<ChunkVertex>& vertices) {
+        for (std::size_t q = 0; q + 3 < vertices.size(); q += 4) {
+            if (static_cast<int>((vertices[q].surface >> 15) & 7u) != face ||
+                static_cast<int>(vertices[q].position & 0x1FFu) != planeX * kChunkPositionScale) {
+                continue;
+            }
+            int yMin = Chunk::HEIGHT * kChunkPositionScale;
+            int yMax = 0;
+            int zMin = Chunk::SIZE * kChunkPositionScale;
+            int zMax = 0;
+            for (std::size_t k = q; k < q + 4; ++k) {
+                const int y = static_cast<int>((vertices[k].position >> 9) & 0x1FFFu);
+                const int z = static_cast<int>((vertices[k].position >> 22) & 0x1FFu);
+                yMin = std::min(yMin, y);
+                yMax = std::max(yMax, y);
+                zMin = std::min(zMin, z);
+                zMax = std::max(zMax, z);
+            }
+            for (int y = yMin / kChunkPositionScale; y < yMax / kChunkPositionScale; ++y) {
+                for (int z = zMin / kChunkPositionScale; z < zMax / kChunkPositionScale; ++z) {
+                    covered[static_cast<std::size_t>(y * Chunk::SIZE + z)] = true;
+                }
+            }
+        }
+    };
+    for (const SectionMeshData& section : mesh.sectionMeshes) {
+        mark(section.solidVertices);
+        mark(section.alphaVertices);
+        mark(section.liquidVertices);
+    }
+}
+
+// 两个沿 X 相邻的 chunk 以各种 LOD 组合构建：接缝平面上一侧被填充、另一侧为空的每一格，
+// 必须被某一侧的边界面盖住，否则透过接缝能看到地形内部。发现漏缝时返回 false
+bool checkLodSeams(const BlockRegistry& registry) {
+    constexpr int kTop = 64;
+    const std::pair<const char*, std::function<BlockId(int, int, int)>> fills[] = {
+        // 平整地面，顶层在 kTop：粗的一侧投票丢掉顶层
+        {"flat", [](int, int y, int) { return y <= kTop ? BlockId::Stone : BlockId::Air; }},
+        // 顶层只在偶数 x/z 上有方块
+        {"even_top", [](int x, int y, int z) {
+             return y < kTop || (y == kTop && x % 2 == 0 && z % 2 == 0) ? BlockId::Stone : BlockId::Air;
+         }},
+        // 沿接缝方向起伏的台阶
+        {"steps", [](int x, int y, int z) {
+             return y <= kTop - 8 + (x + 3 * z) % 13 ? BlockId::Stone : BlockId::Air;
+         }},
+        {"noise_cave", caveBlock},
+    };
+    std::size_t pairs = 0;
+    std::size_t exposed = 0;
+    for (const auto& fill : fills) {
+        Chunk a(ChunkCoord{0, 0}, registry);
+        Chunk b(ChunkCoord{1, 0}, registry);
+        fillVoxels(a, fill.second);
+        fillVoxels(b, fill.second);
+        a.setNeighbor(1, 0, &b);
+        b.setNeighbor(-1, 0, &a);
+        for (int lodA = 0; lodA <= Chunk::MAX_LOD; ++lodA) {
+            for (int lodB = 0; lodB <= Chunk::MAX_LOD; ++lodB) {
+                a.setLod(lodA);
+                b.setLod(lodB);
+                for (GreedyMesher mesher : {GreedyMesher::Binary, GreedyMesher::Reference}) {
+                    std::vector<bool> covered(static_cast<std::size_t>(Chunk::HEIGHT * Chunk::SIZE), false);
+                    markSeamFaces(buildChunkMesh(MeshInput(a), registry, mesher), 0, Chunk::SIZE, covered);
+                    markSeamFaces(buildChunkMesh(MeshInput(b), registry, mesher), 1, 0, covered);
+                    ++pairs;
+                    for (int y = 0; y < Chunk::HEIGHT; ++y) {
+                        for (int z = 0; z < Chunk::SIZE; ++z) {
+                            if (renderedFilled(a, registry, lodA, Chunk::SIZE - 1, y, z) == renderedFilled(b, registry, lodB, 0, y, z)) {
+                                continue;
+                            }
+                            ++exposed;
+                            if (!covered[static_cast<std::size_t>(y * Chunk::SIZE + z)]) {
+                                std::cerr << "LOD seam crack in " << fill.first << " at LOD " << lodA << "|" << lodB
+                                          << ", y=" << y << " z=" << z << std::endl;
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "LOD seams: " << pairs << " chunk pairs, " << exposed << " exposed seam cells, all covered\n";
+    return true;
+}
+
+void report(const std::string& name, const Result& result, double baselineMs) {
+    std::cout << std::left << std::setw(12) << name
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << result.msPerChunk
+              << std::setw(10) << result.quads
+              << std::setw(10) << std::setprecision(2) << baselineMs / result.msPerChunk << "x\n";
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string jsonPath;
+    GreedyMesher suiteMesher = GreedyMesher::Binary;
+    bool suiteOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--mesher") == 0 && i + 1 < argc && std::strcmp(argv[i + 1], "reference") == 0) {
+            suiteMesher = GreedyMesher::Reference;
+            ++i;
+        } else if (std::strcmp(argv[i], "--mesher") == 0 && i + 1 < argc && std::strcmp(argv[i + 1], "binary") == 0) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--suite-only") == 0) {
+            suiteOnly = true;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--json FILE] [--mesher binary|reference] [--suite-only]" << std::endl;
+            return 2;
+        }
+    }
+
+    BlockRegistry registry;
+    const char* mesherName = suiteMesher == GreedyMesher::Binary ? "binary" : "reference";
+    std::vector<ScenarioResult> suite;
+    std::cout << "mesh build suite (" << mesherName << "), " << kSuiteRepeats << " timed builds per chunk\n";
+    std::cout << std::left << std::setw(22) << "scenario" << std::right << std::setw(8) << "chunks" << std::setw(12)
+              << "chunks/s" << std::setw(12) << "quads/chunk" << std::setw(12) << "KB/chunk" << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p99 ms" << "\n";
+    for (const Scenario& scenario : makeScenarios(registry)) {
+        const ScenarioResult r = runScenario(scenario, registry, suiteMesher);
+        std::cout << std::left << std::setw(22) << r.name << std::right << std::setw(8) << r.chunks << std::fixed
+                  << std::setprecision(0) << std::setw(12) << r.chunksPerSecond << std::setw(12) << r.quadsPerChunk
+                  << std::setprecision(1) << std::setw(12) << r.bytesPerChunk / 1024.0 << std::setprecision(3)
+                  << std::setw(10) << r.p50Ms << std::setw(10) << r.p99Ms << "\n";
+        suite.push_back(r);
+    }
+    if (!jsonPath.empty()) {
+        if (!writeJson(jsonPath, suite, mesherName)) {
+            std::cerr << "failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "wrote " << jsonPath << "\n";
+    }
+    if (suiteOnly) {
+        return 0;
+    }
+    std::cout << "\n";
+
+    TerrainGenerator terrain(kSeed, kWaterLevel);
+
+    const int side = 2 * kRadius + 1;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    chunks.reserve(static_cast<std::size_t>(side * side));
+    auto at = [&](int cx, int cz) -> Chunk* {
+        if (cx < -kRadius || cx > kRadius || cz < -kRadius || cz > kRadius) {
+            return nullptr;
+        }
+        return chunks[static_cast<std::size_t>((cz + kRadius) * side + (cx + kRadius))].get();
+    };
+    for (int cz = -kRadius; cz <= kRadius; ++cz) {
+        for (int cx = -kRadius; cx <= kRadius; ++cx) {
+            auto chunk = std::make_unique<Chunk>(ChunkCoord{cx, cz}, registry);
+            terrain.generate(*chunk);
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    std::vector<std::unique_ptr<MeshInput>> inputs;
+    for (int cz = -kRadius + 1; cz < kRadius; ++cz) {
+        for (int cx = -kRadius + 1; cx < kRadius; ++cx) {
+            Chunk* chunk = at(cx, cz);
+            for (int dz = -1; dz <= 1; ++dz) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx != 0 || dz != 0) {
+                        chunk->setNeighbor(dx, dz, at(cx + dx, cz + dz));
+                    }
+                }
+            }
+            inputs.push_back(std::make_unique<MeshInput>(*chunk));
+        }
+    }
+
+    Result reference = run(inputs, registry, GreedyMesher::Reference);
+    Result binary = run(inputs, registry, GreedyMesher::Binary);
+
+    std::cout << "buildChunkMesh over " << inputs.size() << " generated chunks (" << Chunk::SIZE << "x"
+              << Chunk::HEIGHT << "x" << Chunk::SIZE << "), best of " << kRepeats << "\n";
+    std::cout << std::left << std::setw(12) << "mesher"
+              << std::right << std::setw(12) << "ms/chunk"
+              << std::setw(10) << "quads"
+              << std::setw(11) << "speedup" << "\n";
+    report("reference", reference, reference.msPerChunk);
+    report("binary", binary, reference.msPerChunk);
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (!sameMesh(reference.meshes[i], binary.meshes[i])) {
+            std::cerr << "mesh mismatch for chunk " << inputs[i]->coord().x << "," << inputs[i]->coord().z << std::endl;
+            return 1;
+        }
+    }
+
+    // 在每个内圈 chunk 中心列的地表上放一块石头，只重建 setBlock 标脏的分段，
+    // 结果须与整 chunk 重建中对应分段完全一致
+    double fullMs = 0.0;
+    double partialMs = 0.0;
+    int partialSections = 0;
+    for (int cz = -kRadius + 1; cz < kRadius; ++cz) {
+        for (int cx = -kRadius + 1; cx < kRadius; ++cx) {
+            Chunk* chunk = at(cx, cz);
+            const int x = Chunk::SIZE / 2;
+            const int z = Chunk::SIZE / 2;
+            const int y = std::min(chunk->surfaceHeight(x, z) + 1, Chunk::HEIGHT - 1);
+            chunk->takeDirtySections();
+            chunk->setBlock(x, y, z, BlockId::Stone);
+            const Chunk::SectionMask dirty = chunk->takeDirtySections();
+
+            ChunkMeshData full;
+            ChunkMeshData partial;
+            fullMs += timeRebuild(*chunk, registry, Chunk::ALL_SECTIONS, full);
+            partialMs += timeRebuild(*chunk, registry, dirty, partial);
+            for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+                if (!((dirty >> s) & 1u)) continue;
+                ++partialSections;
+                if (!sameSection(full.sectionMeshes[static_cast<std::size_t>(s)], partial.sectionMeshes[static_cast<std::size_t>(s)])) {
+                    std::cerr << "section " << s << " mismatch after edit in chunk " << cx << "," << cz << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    const double edits = static_cast<double>(inputs.size());
+    std::cout << "\nsingle block edit, snapshot + build (binary), avg over " << inputs.size() << " chunks\n";
+    std::cout << std::left << std::setw(12) << "full chunk" << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << fullMs / edits << " ms\n";
+    std::cout << std::left << std::setw(12) << "sections" << std::right << std::setw(12) << partialMs / edits << " ms ("
+              << std::setprecision(1) << partialSections / edits << " sections)\n";
+
+    if (!checkLodSeams(registry)) {
+        return 1;
+    }
+
+    // 各 LOD 级别：平均每 chunk 的构建耗时与四边形数
+    std::array<double, Chunk::MAX_LOD + 1> lodQuads{};
+    std::cout << "\nLOD meshes (binary), avg over " << inputs.size() << " chunks\n";
+    std::cout << std::left << std::setw(12) << "lod" << std::right << std::setw(12) << "ms/chunk" << std::setw(10)
+              << "quads" << "\n";
+    for (int lod = 0; lod <= Chunk::MAX_LOD; ++lod) {
+        std::vector<std::unique_ptr<MeshInput>> lodInputs;
+        for (const auto& input : inputs) {
+            Chunk* chunk = at(input->coord().x, input->coord().z);
+            chunk->setLod(lod);
+            lodInputs.push_back(std::make_unique<MeshInput>(*chunk));
+        }
+        Result result = run(lodInputs, registry, GreedyMesher::Binary);
+        lodQuads[static_cast<std::size_t>(lod)] = static_cast<double>(result.quads) / edits;
+        std::cout << std::left << std::setw(12) << lod << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.msPerChunk << std::setw(10) << result.quads << "\n";
+    }
+
+    // 视距内（同 World::ensureChunksAround 的圆形范围）chunk 按与中心的距离落入的 LOD 环，
+    // 半径取 World::kLodRadii，不计滞后
+    auto estimate = [&](int renderDistance, bool useLod) {
+        double quads = 0.0;
+        for (int dz = -renderDistance; dz <= renderDistance; ++dz) {
+            for (int dx = -renderDistance; dx <= renderDistance; ++dx) {
+                if (dx * dx + dz * dz > renderDistance * renderDistance + renderDistance) continue;
+                const float distance = std::sqrt(static_cast<float>(dx * dx + dz * dz));
+                int lod = 0;
+                for (float radius : {8.0f, 14.0f, 22.0f}) {
+                    lod += useLod && distance > radius ? 1 : 0;
+                }
+                quads += lodQuads[static_cast<std::size_t>(lod)];
+            }
+        }
+        return quads;
+    };
+    std::cout << "\nestimated quads in view: distance 8 " << std::setprecision(0) << estimate(8, false)
+              << ", distance 32 without LOD " << estimate(32, false) << ", with LOD " << estimate(32, true) << "\n";
+
+    // 像 World 那样把上传完的输出交给下一次构建：先各跑一遍让线程临时缓冲与输出数组长到峰值，
+    // 之后再构建应不再分配；LOD 各级交替构建，覆盖所有路径的缓冲
+    std::vector<std::unique_ptr<MeshInput>> mixedInputs;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        Chunk* chunk = at(inputs[i]->coord().x, inputs[i]->coord().z);
+        chunk->setLod(static_cast<int>(i % (Chunk::MAX_LOD + 1)));
+        mixedInputs.push_back(std::make_unique<MeshInput>(*chunk));
+    }
+    std::array<ChunkMeshData, 4> outputs;
+    std::cout << "\nrecycled outputs (" << outputs.size() << "), mixed LOD, heap allocations per build\n";
+    std::cout << std::left << std::setw(12) << "pass" << std::right << std::setw(12) << "ms/chunk" << std::setw(10)
+              << "allocs" << std::setw(10) << "grown" << "\n";
+    for (int pass = 0; pass < 3; ++pass) {
+        std::size_t allocations = 0;
+        std::size_t grown = 0;
+        double ms = 0.0;
+        for (std::size_t i = 0; i < mixedInputs.size(); ++i) {
+            ChunkMeshData& out = outputs[i % outputs.size()];
+            const std::size_t before = heapAllocations.load();
+            const Clock::time_point start = Clock::now();
+            buildChunkMesh(*mixedInputs[i], registry, out);
+            ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            allocations += heapAllocations.load() - before;
+            grown += out.allocations;
+        }
+        const double builds = static_cast<double>(mixedInputs.size());
+        std::cout << std::left << std::setw(12) << pass << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << ms / builds << std::setprecision(2) << std::setw(10)
+                  << static_cast<double>(allocations) / builds << std::setw(10) << static_cast<double>(grown) / builds
+                  << "\n";
+        if (pass > 0 && allocations != 0) {
+            std::cerr << "steady-state build allocated " << allocations << " times" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
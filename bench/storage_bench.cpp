@@ -0,0 +1,138 @@
+// 方块存储微基准：对比旧的扁平 std::vector<BlockId> 与 Chunk 的分段调色板压缩存储
+// 在顺序遍历和随机访问下的 block() 吞吐量，以及常驻内存。
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chunk.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSequentialPasses = 64;
+constexpr int kRandomLookups = 1 << 22;
+
+inline std::size_t flatIndex(int x, int y, int z) {
+    return static_cast<std::size_t>(y * Chunk::SIZE * Chunk::SIZE + z * Chunk::SIZE + x);
+}
+
+// 与 Chunk 旧实现一致的基线：越界返回空气，否则直接按下标读取
+struct FlatStorage {
+    std::vector<BlockId> blocks = std::vector<BlockId>(static_cast<std::size_t>(Chunk::SIZE * Chunk::HEIGHT * Chunk::SIZE), BlockId::Air);
+
+    BlockId block(int x, int y, int z) const {
+        if (x < 0 || x >= Chunk::SIZE || y < 0 || y >= Chunk::HEIGHT || z < 0 || z >= Chunk::SIZE) {
+            return BlockId::Air;
+        }
+        return blocks[flatIndex(x, y, z)];
+    }
+};
+
+std::uint32_t xorshift(std::uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 近似真实地形的一列：石头/泥土/草/水/空气，外加少量植被
+BlockId terrainAt(int x, int y, int z) {
+    int height = 40 + ((x * 7 + z * 13) % 9);
+    if (y < height - 3) return BlockId::Stone;
+    if (y < height) return BlockId::Dirt;
+    if (y == height) return height < 44 ? BlockId::Sand : BlockId::Grass;
+    if (y <= 43) return BlockId::Water;
+    if (y == height + 1 && (x * 31 + z * 17) % 11 == 0) return BlockId::TallGrass;
+    return BlockId::Air;
+}
+
+template <typename Storage>
+double sequentialNs(const Storage& storage, std::uint64_t& checksum) {
+    auto start = Clock::now();
+    for (int pass = 0; pass < kSequentialPasses; ++pass) {
+        for (int y = 0; y < Chunk::HEIGHT; ++y) {
+            for (int z = 0; z < Chunk::SIZE; ++z) {
+                for (int x = 0; x < Chunk::SIZE; ++x) {
+                    checksum += static_cast<std::uint64_t>(storage.block(x, y, z));
+                }
+            }
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return ns / (static_cast<double>(kSequentialPasses) * Chunk::SIZE * Chunk::SIZE * Chunk::HEIGHT);
+}
+
+template <typename Storage>
+double randomNs(const Storage& storage, const std::vector<glm::ivec3>& coords, std::uint64_t& checksum) {
+    auto start = Clock::now();
+    for (const glm::ivec3& c : coords) {
+        checksum += static_cast<std::uint64_t>(storage.block(c.x, c.y, c.z));
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return ns / static_cast<double>(coords.size());
+}
+
+void report(const std::string& name, double seqNs, double randNs, std::size_t bytes) {
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << seqNs
+              << std::setw(12) << randNs
+              << std::setw(12) << bytes << "\n";
+}
+} // namespace
+
+int main() {
+    FlatStorage flat;
+    BlockRegistry registry;
+    Chunk chunk(ChunkCoord{0, 0}, registry);
+    for (int y = 0; y < Chunk::HEIGHT; ++y) {
+        for (int z = 0; z < Chunk::SIZE; ++z) {
+            for (int x = 0; x < Chunk::SIZE; ++x) {
+                BlockId id = terrainAt(x, y, z);
+                flat.blocks[flatIndex(x, y, z)] = id;
+                chunk.setBlock(x, y, z, id);
+            }
+        }
+    }
+    chunk.compactStorage();
+
+    std::vector<glm::ivec3> coords;
+    coords.reserve(kRandomLookups);
+    std::uint32_t state = 0x9E3779B9u;
+    for (int i = 0; i < kRandomLookups; ++i) {
+        std::uint32_t r = xorshift(state);
+        coords.emplace_back(static_cast<int>(r % Chunk::SIZE),
+                            static_cast<int>((r >> 8) % Chunk::HEIGHT),
+                            static_cast<int>((r >> 20) % Chunk::SIZE));
+    }
+
+    std::uint64_t checksumFlat = 0;
+    std::uint64_t checksumPalette = 0;
+    double flatSeq = sequentialNs(flat, checksumFlat);
+    double flatRand = randomNs(flat, coords, checksumFlat);
+    double paletteSeq = sequentialNs(chunk, checksumPalette);
+    double paletteRand = randomNs(chunk, coords, checksumPalette);
+
+    std::cout << "block() throughput, ns per lookup (" << Chunk::SIZE << "x" << Chunk::HEIGHT << "x" << Chunk::SIZE << ")\n";
+    std::cout << std::left << std::setw(16) << "storage"
+              << std::right << std::setw(12) << "sequential"
+              << std::setw(12) << "random"
+              << std::setw(12) << "bytes" << "\n";
+    report("vector", flatSeq, flatRand, flat.blocks.capacity() * sizeof(BlockId));
+    report("palette", paletteSeq, paletteRand, chunk.storageBytes());
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        const PaletteStorage& section = chunk.section(s);
+        std::cout << "section " << s << ": " << section.paletteSize() << " ids, "
+                  << section.bitsPerEntry() << " bits/voxel"
+                  << (section.uniform() ? " (uniform)" : "") << "\n";
+    }
+
+    if (checksumFlat != checksumPalette) {
+        std::cerr << "checksum mismatch: " << checksumFlat << " vs " << checksumPalette << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#version 410 core
+
+// 植物十字面片的实例化绘制：每个实例是一株植物（位布局同 ChunkVertex，position 为底面中心），
+// 两个交叉四边形的角点按 gl_VertexID（共用索引缓冲给出 0..7）生成；输出与 chunk.vert 相同的 VS_OUT
+layout(location = 0) in uvec3 aInstance;
+
+out VS_OUT {
+    vec3 fragPos;
+    vec3 normal;
+    vec2 uv;
+    vec3 color;
+    float light;
+    float material;
+    vec3 anim;
+    float biome;
+    vec4 fragPosLightSpace;
+} vs_out;
+
+uniform mat4 uViewProj;
+uniform mat4 uLightSpace;
+uniform vec3 uChunkOrigin;
+uniform vec2 uAnimations[15]; // 动画槽 1..15 的 (帧数, 速度)
+
+const float kPositionScale = 1.0 / 16.0;
+// 前 4 个角为沿 X 的面片，后 4 个为沿 Z 的面片，相对底面中心
+const vec3 kCorners[8] = vec3[](vec3(-0.5, 0.0, 0.0), vec3(0.5, 0.0, 0.0), vec3(0.5, 1.0, 0.0), vec3(-0.5, 1.0, 0.0),
+                                vec3(0.0, 0.0, -0.5), vec3(0.0, 0.0, 0.5), vec3(0.0, 1.0, 0.5), vec3(0.0, 1.0, -0.5));
+const vec2 kCornerUV[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    uint position = aInstance.x;
+    uint surface = aInstance.y;
+    uint color = aInstance.z;
+
+    vec3 base = vec3(float(position & 0x1FFu), float((position >> 9) & 0x1FFFu), float((position >> 22) & 0x1FFu)) * kPositionScale;
+    vec3 worldPos = uChunkOrigin + base + kCorners[gl_VertexID & 7];
+
+    int animation = int((surface >> 20) & 15u);
+    float emission = float(surface >> 28) / 15.0;
+    float layer = float(color >> 24);
+
+    vs_out.fragPos = worldPos;
+    vs_out.normal = vec3(0.0, 1.0, 0.0);
+    vs_out.uv = kCornerUV[gl_VertexID & 3];
+    vs_out.color = vec3(float(color & 255u), float((color >> 8) & 255u), float((color >> 16) & 255u)) / 255.0 + vec3(emission);
+    // 与 chunk.vert 中的 billboard 一致：不受面朝向与 AO 影响
+    vs_out.light = 1.0;
+    vs_out.material = float((surface >> 24) & 15u) / 8.0;
+    vs_out.anim = animation > 0 ? vec3(layer, uAnimations[animation - 1]) : vec3(layer, 1.0, 0.0);
+    vs_out.biome = float(position >> 31);
+    vs_out.fragPosLightSpace = uLightSpace * vec4(worldPos, 1.0);
+    gl_Position = uViewProj * vec4(worldPos, 1.0);
+}
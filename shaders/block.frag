@@ -8,6 +8,7 @@ in VS_OUT {
     float light;
     float material;
     vec3 anim;
+    float biome;
     vec4 fragPosLightSpace;
 } fs_in;
 
@@ -18,6 +19,8 @@ uniform sampler2D uPigTex;
 uniform sampler2D uCowTex;
 uniform sampler2D uSheepTex;
 uniform sampler2D uShadowMap;
+uniform sampler2D uBiomeTint; // BiomeTintMap：按世界 XZ 环绕寻址的列颜色
+uniform float uBiomeTintInvSize;
 uniform vec3 uSunDir;
 uniform vec3 uSunColor;
 uniform vec3 uAmbient;
@@ -37,6 +40,14 @@ uniform float uAtlasTileSize;
 uniform int uAnimalKind; // 0=pig,1=cow,2=sheep
 uniform float uAoStrength;
 
+// 生物群系颜色：纹理中的列颜色随海拔向山地色过渡（逐片元计算，合并后的大面也能平滑变色）
+vec3 biomeColor(vec3 worldPos) {
+    vec3 column = texture(uBiomeTint, worldPos.xz * uBiomeTintInvSize).rgb;
+    vec3 mountain = vec3(0.6, 0.65, 0.55); // 山地/冷色调
+    float elevation = clamp(worldPos.y / 120.0, 0.0, 1.0);
+    return clamp(mix(column, mountain, smoothstep(0.5, 0.9, elevation)), 0.0, 1.0);
+}
+
 float hash21(vec2 p) {
     p = fract(p * vec2(234.34, 435.345));
     p += dot(p, p + 34.45);
@@ -179,7 +190,8 @@ void main() {
         if (texData.a < 0.5) {
             discard;
         }
-        vec3 albedo = texData.rgb * fs_in.color;
+        vec3 tint = fs_in.biome > 0.5 ? fs_in.color * biomeColor(fs_in.fragPos) : fs_in.color;
+        vec3 albedo = texData.rgb * tint;
         vec3 F0 = vec3(0.04);
         float shininess = 32.0;
         float specStrength = 0.35;
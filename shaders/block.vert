@@ -16,6 +16,7 @@ out VS_OUT {
     float light;
     float material;
     vec3 anim;
+    float biome;
     vec4 fragPosLightSpace;
 } vs_out;
 
@@ -33,6 +34,7 @@ void main() {
     vs_out.light = aLight;
     vs_out.material = aMaterial;
     vs_out.anim = aAnim;
+    vs_out.biome = 0.0;
     vs_out.fragPosLightSpace = uLightSpace * worldPos;
     gl_Position = uViewProj * worldPos;
 }
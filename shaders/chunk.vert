@@ -0,0 +1,56 @@
+#version 410 core
+
+// chunk mesh 专用：解码 12 字节的压缩顶点（位布局见 src/mesh.h 的 ChunkVertex），
+// 输出与 block.vert 相同的 VS_OUT，片元着色器共用 block.frag
+layout(location = 0) in uvec3 aPacked;
+
+out VS_OUT {
+    vec3 fragPos;
+    vec3 normal;
+    vec2 uv;
+    vec3 color;
+    float light;
+    float material;
+    vec3 anim;
+    float biome;
+    vec4 fragPosLightSpace;
+} vs_out;
+
+uniform mat4 uViewProj;
+uniform mat4 uLightSpace;
+uniform vec3 uChunkOrigin;
+uniform vec2 uAnimations[15]; // 动画槽 1..15 的 (帧数, 速度)
+
+const float kPositionScale = 1.0 / 16.0;
+const vec3 kNormals[7] = vec3[](vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+                                vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+                                vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+                                vec3(0.0, 1.0, 0.0)); // 6: billboard
+const float kFaceLight[6] = float[](0.92, 0.92, 1.2, 0.7, 1.0, 1.0);
+
+void main() {
+    uint position = aPacked.x;
+    uint surface = aPacked.y;
+    uint color = aPacked.z;
+
+    vec3 local = vec3(float(position & 0x1FFu), float((position >> 9) & 0x1FFFu), float((position >> 22) & 0x1FFu)) * kPositionScale;
+    vec3 worldPos = uChunkOrigin + local;
+
+    int face = int((surface >> 15) & 7u);
+    float occlusion = float((surface >> 18) & 3u);
+    int animation = int((surface >> 20) & 15u);
+    float emission = float(surface >> 28) / 15.0;
+    float layer = float(color >> 24);
+
+    vs_out.fragPos = worldPos;
+    vs_out.normal = kNormals[face];
+    vs_out.uv = vec2(float(surface & 31u), float((surface >> 5) & 1023u));
+    vs_out.color = vec3(float(color & 255u), float((color >> 8) & 255u), float((color >> 16) & 255u)) / 255.0 + vec3(emission);
+    // billboard 不受面朝向与 AO 影响
+    vs_out.light = face < 6 ? clamp(kFaceLight[face] * (1.0 - occlusion * 0.25) + emission, 0.2, 1.0) : 1.0;
+    vs_out.material = float((surface >> 24) & 15u) / 8.0;
+    vs_out.anim = animation > 0 ? vec3(layer, uAnimations[animation - 1]) : vec3(layer, 1.0, 0.0);
+    vs_out.biome = float(position >> 31);
+    vs_out.fragPosLightSpace = uLightSpace * vec4(worldPos, 1.0);
+    gl_Position = uViewProj * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,15 @@
+#version 410 core
+
+// chunk mesh 的阴影 pass：只解码压缩顶点中的位置（见 chunk.vert）
+layout(location = 0) in uvec3 aPacked;
+
+uniform mat4 uLightSpace;
+uniform vec3 uChunkOrigin;
+
+const float kPositionScale = 1.0 / 16.0;
+
+void main() {
+    uint position = aPacked.x;
+    vec3 local = vec3(float(position & 0x1FFu), float((position >> 9) & 0x1FFFu), float((position >> 22) & 0x1FFu)) * kPositionScale;
+    gl_Position = uLightSpace * vec4(uChunkOrigin + local, 1.0);
+}
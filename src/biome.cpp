@@ -0,0 +1,40 @@
+#include "biome.h"
+
+#include <glm/gtc/noise.hpp>
+
+glm::vec3 biomeColumnColor(int seed, float worldX, float worldZ) {
+    // 使用 3D 坐标来引入种子，避免直接在 2D 坐标上加大数值种子导致精度丢失
+    glm::vec3 pos = glm::vec3(worldX * 0.0022f, worldZ * 0.0022f, static_cast<float>(seed) * 0.1337f);
+
+    // perlin 3D
+    float temperature = glm::clamp(glm::perlin(pos * 0.8f + 13.7f) * 0.5f + 0.5f, 0.0f, 1.0f);
+    float moisture = glm::clamp(glm::perlin(pos * 1.4f - 17.3f) * 0.5f + 0.5f, 0.0f, 1.0f);
+
+    // 各类基色，用于混合出不同生物群系的草地颜色（使用更接近原版的颜色）
+    // 为了在经过 ToneMapping 和 Gamma 校正后呈现 RGB(107, 151, 71)，输入值需要显著降低
+    glm::vec3 plains(38.0f / 255.0f, 97.0f / 255.0f, 15.0f / 255.0f);
+    glm::vec3 desert(0.93f, 0.86f, 0.52f);    // 沙漠/热带草原黄
+    glm::vec3 swamp(0.28f, 0.32f, 0.22f);     // 沼泽暗绿
+
+    // 先基于湿度混合出基础绿色（从平原到沼泽）
+    glm::vec3 baseColor = glm::mix(plains, swamp, glm::smoothstep(0.4f, 0.8f, moisture));
+    // 基于温度混合沙漠色
+    return glm::mix(baseColor, desert, glm::smoothstep(0.5f, 0.9f, temperature));
+}
+
+// info.tint: BlockInfo 中存储的基础 tint（可被生物群系调制）
+BlockTint blockTint(const BlockRegistry& registry, BlockId id, int face) {
+    const BlockInfo& info = registry.info(id);
+
+    if (id == BlockId::Grass) {
+        if (face == 2) { // Top Face
+            // 使用纯生物群系颜色，不乘基础 tint，以保证颜色准确
+            return BlockTint{glm::vec3(1.0f), true};
+        }
+        // Sides (0,1,4,5) and Bottom (3)
+        // 强制使用泥土颜色 (#866043 -> 134, 96, 67)
+        return BlockTint{glm::vec3(0.525f, 0.376f, 0.263f), false};
+    }
+
+    return BlockTint{info.tint, info.biomeTint};
+}
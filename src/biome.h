@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "voxel_block.h"
+
+// 生物群系染色（草/叶等 biomeTint 方块的颜色）。
+// 温度与湿度只取决于水平位置，由 BiomeTintMap 在 chunk 加载时按列算好放进纹理；
+// 海拔带来的山地色过渡与逐片元采样在 block.frag 中完成，mesher 只标记哪些面需要染色。
+
+// 列 (worldX, worldZ) 处由温度/湿度混合出的基础颜色
+glm::vec3 biomeColumnColor(int seed, float worldX, float worldZ);
+
+// BlockTint: 方块某个面的顶点颜色；biome 为真时 block.frag 还要乘以所在位置的生物群系颜色
+struct BlockTint {
+    glm::vec3 color{1.0f};
+    bool biome = false;
+};
+BlockTint blockTint(const BlockRegistry& registry, BlockId id, int face);
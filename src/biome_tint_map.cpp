@@ -0,0 +1,59 @@
+#include "biome_tint_map.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "biome.h"
+
+BiomeTintMap::~BiomeTintMap() {
+    if (texture_) {
+        glDeleteTextures(1, &texture_);
+    }
+}
+
+void BiomeTintMap::update(ChunkCoord coord, int seed) {
+    if (!texture_) {
+        glGenTextures(1, &texture_);
+        glBindTexture(GL_TEXTURE_2D, texture_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kSize, kSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
+    // 每个 texel 在它覆盖的 kBlocksPerTexel² 列的中心采样，正好落在 texel 中心
+    const int originX = coord.x * Chunk::SIZE;
+    const int originZ = coord.z * Chunk::SIZE;
+    const float half = 0.5f * static_cast<float>(kBlocksPerTexel);
+    std::array<std::uint8_t, kChunkTexels * kChunkTexels * 4> texels{};
+    for (int z = 0; z < kChunkTexels; ++z) {
+        for (int x = 0; x < kChunkTexels; ++x) {
+            const glm::vec3 color = glm::clamp(
+                biomeColumnColor(seed, static_cast<float>(originX + x * kBlocksPerTexel) + half,
+                                 static_cast<float>(originZ + z * kBlocksPerTexel) + half),
+                glm::vec3(0.0f), glm::vec3(1.0f));
+            std::uint8_t* texel = &texels[static_cast<std::size_t>(z * kChunkTexels + x) * 4];
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = static_cast<std::uint8_t>(std::lround(color[c] * 255.0f));
+            }
+            texel[3] = 255;
+        }
+    }
+
+    // 负坐标也要映射到 [0, kSize)
+    const int wrapX = ((coord.x * kChunkTexels % kSize) + kSize) % kSize;
+    const int wrapZ = ((coord.z * kChunkTexels % kSize) + kSize) % kSize;
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, wrapX, wrapZ, kChunkTexels, kChunkTexels, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+}
+
+void BiomeTintMap::bind(int unit) const {
+    glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+    glBindTexture(GL_TEXTURE_2D, texture_);
+}
+
+std::size_t BiomeTintMap::gpuBytes() const {
+    return texture_ ? static_cast<std::size_t>(kSize) * kSize * 4 : 0;
+}
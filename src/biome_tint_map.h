@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "chunk.h"
+
+// BiomeTintMap: 按世界 XZ 环绕寻址的生物群系颜色纹理（kSize×kSize，每个 texel 覆盖
+// kBlocksPerTexel×kBlocksPerTexel 列）。chunk 加载时算一次它的 texel 颜色写入
+// (x/kBlocksPerTexel mod kSize, z/kBlocksPerTexel mod kSize) 处；只要已加载范围不超过
+// kSize*kBlocksPerTexel 格宽（渲染半径 32 时约 1100 格），不同 chunk 就不会互相覆盖。
+// biomeColumnColor 的变化周期有数百格，block.frag 以 GL_REPEAT + 线性过滤按片元采样，
+// 看不出 texel 的粗细。仅主线程使用。
+class BiomeTintMap {
+public:
+    static constexpr int kSize = 512;
+    static constexpr int kBlocksPerTexel = 4;
+    static constexpr int kChunkTexels = Chunk::SIZE / kBlocksPerTexel;
+    static_assert(Chunk::SIZE % kBlocksPerTexel == 0, "texels must not straddle chunk borders");
+    static_assert(kSize % kChunkTexels == 0, "chunks must not straddle the wrap-around edge");
+
+    BiomeTintMap() = default;
+    ~BiomeTintMap();
+    BiomeTintMap(const BiomeTintMap&) = delete;
+    BiomeTintMap& operator=(const BiomeTintMap&) = delete;
+
+    // 在 chunk 内各 texel 的中心计算 biomeColumnColor 并上传；会改变当前纹理单元上 GL_TEXTURE_2D 的绑定
+    void update(ChunkCoord coord, int seed);
+    // 绑定到纹理单元 GL_TEXTURE0 + unit（纹理尚未创建时绑定 0）
+    void bind(int unit) const;
+
+    std::size_t gpuBytes() const;
+
+private:
+    GLuint texture_ = 0;
+};
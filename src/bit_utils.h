@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// 64 位掩码的位扫描小工具（C++17 没有 <bit>，GCC/Clang 走内建指令，其它编译器退化为循环）。
+
+// 最高置位的下标；mask 必须非 0
+inline int highestBit(std::uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(mask);
+#else
+    int index = 0;
+    while (mask >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// 最低置位的下标；mask 必须非 0
+inline int lowestBit(std::uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// [from, to] 闭区间内的位全为 1 的掩码（0 <= from <= to <= 63）
+inline std::uint64_t bitRange(int from, int to) {
+    const std::uint64_t high = to >= 63 ? ~std::uint64_t{0} : ((std::uint64_t{1} << (to + 1)) - 1);
+    return high & ~((std::uint64_t{1} << from) - 1);
+}
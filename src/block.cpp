@@ -2,36 +2,16 @@
 
 #include <stdexcept>
 
+#include "mesh.h"
 #include "texture_atlas.h"
 
 BlockRegistry::BlockRegistry() {
     for (auto& block : blocks_) {
         block = BlockInfo{};
     }
-}
-
-void BlockRegistry::build(const TextureAtlas& atlas) {
-    auto texture = [&](const std::string& name) {
-        int index = atlas.tileIndex(name);
-        if (index < 0) {
-            throw std::runtime_error("缺少纹理:" + name);
-        }
-        return index;
-    };
-
-    auto applyAnimation = [&](BlockInfo& info, const std::string& name) {
-        AtlasAnimation anim = atlas.animationInfo(name);
-        if (anim.startIndex >= 0 && anim.frameCount > 1) {
-            info.animation.start = anim.startIndex;
-            info.animation.frames = anim.frameCount;
-            info.animation.speed = anim.speed > 0.0f ? anim.speed : 1.0f;
-        }
-    };
-
-    auto assign = [&](BlockInfo& info, int px, int nx, int py, int ny, int pz, int nz) {
-        info.faces = {px, nx, py, ny, pz, nz};
-    };
 
+    // 物理/渲染属性与纹理无关，在构造时就确定；
+    // 这样不依赖 GL/纹理图集的代码（chunk 占用掩码、地形生成、基准测试）也能直接使用。
     BlockInfo& air = slot(BlockId::Air);
     air.transparent = true;
     air.selectable = false;
@@ -40,36 +20,28 @@ void BlockRegistry::build(const TextureAtlas& atlas) {
     grass.solid = true;
     grass.selectable = true;
     grass.biomeTint = true;
-    assign(grass,
-           texture("grass_side"), texture("grass_side"), texture("grass_top"), texture("dirt"),
-           texture("grass_side"), texture("grass_side"));
     grass.tint = glm::vec3(0.48f, 0.65f, 0.36f);
 
     BlockInfo& dirt = slot(BlockId::Dirt);
     dirt.solid = true;
     dirt.selectable = true;
-    assign(dirt, texture("dirt"), texture("dirt"), texture("dirt"), texture("dirt"), texture("dirt"), texture("dirt"));
 
     BlockInfo& stone = slot(BlockId::Stone);
     stone.solid = true;
     stone.selectable = true;
-    assign(stone, texture("stone"), texture("stone"), texture("stone"), texture("stone"), texture("stone"), texture("stone"));
 
     BlockInfo& sand = slot(BlockId::Sand);
     sand.solid = true;
     sand.selectable = true;
     sand.tint = glm::vec3(1.0f, 0.95f, 0.82f);
-    assign(sand, texture("sand"), texture("sand"), texture("sand"), texture("sand"), texture("sand"), texture("sand"));
 
     BlockInfo& gravel = slot(BlockId::Gravel);
     gravel.solid = true;
     gravel.selectable = true;
-    assign(gravel, texture("gravel"), texture("gravel"), texture("gravel"), texture("gravel"), texture("gravel"), texture("gravel"));
 
     BlockInfo& snow = slot(BlockId::Snow);
     snow.solid = true;
     snow.selectable = true;
-    assign(snow, texture("snow"), texture("snow"), texture("snow"), texture("snow"), texture("snow"), texture("snow"));
 
     BlockInfo& water = slot(BlockId::Water);
     water.solid = false;
@@ -78,13 +50,10 @@ void BlockRegistry::build(const TextureAtlas& atlas) {
     water.liquid = true;
     water.material = 1.0f;
     water.tint = glm::vec3(0.2f, 0.35f, 0.65f);
-    assign(water, texture("water"), texture("water"), texture("water"), texture("water"), texture("water"), texture("water"));
-    applyAnimation(water, "water");
 
     BlockInfo& log = slot(BlockId::OakLog);
     log.solid = true;
     log.selectable = true;
-    assign(log, texture("oak_log"), texture("oak_log"), texture("oak_log_top"), texture("oak_log_top"), texture("oak_log"), texture("oak_log"));
 
     BlockInfo& leaves = slot(BlockId::OakLeaves);
     leaves.solid = true;
@@ -92,35 +61,16 @@ void BlockRegistry::build(const TextureAtlas& atlas) {
     leaves.selectable = true;
     leaves.biomeTint = true;
     leaves.tint = glm::vec3(1.0f);
-    assign(leaves, texture("oak_leaves"), texture("oak_leaves"), texture("oak_leaves"), texture("oak_leaves"), texture("oak_leaves"), texture("oak_leaves"));
 
     BlockInfo& planks = slot(BlockId::OakPlanks);
     planks.solid = true;
     planks.selectable = true;
-    assign(planks, texture("oak_planks"), texture("oak_planks"), texture("oak_planks"), texture("oak_planks"), texture("oak_planks"), texture("oak_planks"));
 
     BlockInfo& glass = slot(BlockId::Glass);
     glass.solid = true;
     glass.transparent = true;
     glass.selectable = true;
     glass.material = 1.1f;
-    assign(glass, texture("glass"), texture("glass"), texture("glass"), texture("glass"), texture("glass"), texture("glass"));
-
-    BlockInfo& flower = slot(BlockId::Flower);
-    flower.solid = false;
-    flower.transparent = true;
-    flower.selectable = true;
-    flower.billboard = true;
-    flower.tint = glm::vec3(1.0f);
-    assign(flower, texture("poppy"), texture("poppy"), texture("poppy"), texture("poppy"), texture("poppy"), texture("poppy"));
-
-    BlockInfo& dandelion = slot(BlockId::Dandelion);
-    dandelion.solid = false;
-    dandelion.transparent = true;
-    dandelion.selectable = true;
-    dandelion.billboard = true;
-    dandelion.tint = glm::vec3(1.0f);
-    assign(dandelion, texture("dandelion"), texture("dandelion"), texture("dandelion"), texture("dandelion"), texture("dandelion"), texture("dandelion"));
 
     BlockInfo& tallGrass = slot(BlockId::TallGrass);
     tallGrass.solid = false;
@@ -129,31 +79,30 @@ void BlockRegistry::build(const TextureAtlas& atlas) {
     tallGrass.billboard = true;
     tallGrass.biomeTint = true;
     tallGrass.tint = glm::vec3(1.0f);
-    assign(tallGrass, texture("tall_grass"), texture("tall_grass"), texture("tall_grass"), texture("tall_grass"), texture("tall_grass"), texture("tall_grass"));
 
     // Helper for simple flowers
-    auto registerFlower = [&](BlockId id, const std::string& texName) {
+    auto registerFlower = [&](BlockId id) {
         BlockInfo& info = slot(id);
         info.solid = false;
         info.transparent = true;
         info.selectable = true;
         info.billboard = true;
         info.tint = glm::vec3(1.0f);
-        int t = texture(texName);
-        assign(info, t, t, t, t, t, t);
     };
 
-    registerFlower(BlockId::DeadBush, "dead_bush");
-    registerFlower(BlockId::BlueOrchid, "blue_orchid");
-    registerFlower(BlockId::Allium, "allium");
-    registerFlower(BlockId::AzureBluet, "azure_bluet");
-    registerFlower(BlockId::RedTulip, "red_tulip");
-    registerFlower(BlockId::OrangeTulip, "orange_tulip");
-    registerFlower(BlockId::WhiteTulip, "white_tulip");
-    registerFlower(BlockId::PinkTulip, "pink_tulip");
-    registerFlower(BlockId::OxeyeDaisy, "oxeye_daisy");
-    registerFlower(BlockId::Cornflower, "cornflower");
-    registerFlower(BlockId::LilyOfTheValley, "lily_of_the_valley");
+    registerFlower(BlockId::Flower);
+    registerFlower(BlockId::Dandelion);
+    registerFlower(BlockId::DeadBush);
+    registerFlower(BlockId::BlueOrchid);
+    registerFlower(BlockId::Allium);
+    registerFlower(BlockId::AzureBluet);
+    registerFlower(BlockId::RedTulip);
+    registerFlower(BlockId::OrangeTulip);
+    registerFlower(BlockId::WhiteTulip);
+    registerFlower(BlockId::PinkTulip);
+    registerFlower(BlockId::OxeyeDaisy);
+    registerFlower(BlockId::Cornflower);
+    registerFlower(BlockId::LilyOfTheValley);
 
     BlockInfo& cactus = slot(BlockId::Cactus);
     cactus.solid = true;
@@ -162,7 +111,87 @@ void BlockRegistry::build(const TextureAtlas& atlas) {
     // Cactus model is slightly smaller than block, but we treat as solid block with texture for now or billboard? 
     // Minecraft cactus is a block model. Let's treating it as a standard block but maybe with inset?
     // Standard block for now to keep it simple, or reduce hit shape.
-    assign(cactus, texture("cactus_side"), texture("cactus_side"), texture("cactus_top"), texture("cactus_bottom"), texture("cactus_side"), texture("cactus_side"));
+}
+
+void BlockRegistry::build(const TextureAtlas& atlas) {
+    auto texture = [&](const std::string& name) {
+        int index = atlas.tileIndex(name);
+        if (index < 0) {
+            throw std::runtime_error("缺少纹理:" + name);
+        }
+        return index;
+    };
+
+    auto applyAnimation = [&](BlockInfo& info, const std::string& name) {
+        AtlasAnimation anim = atlas.animationInfo(name);
+        if (anim.startIndex >= 0 && anim.frameCount > 1) {
+            info.animation.start = anim.startIndex;
+            info.animation.frames = anim.frameCount;
+            info.animation.speed = anim.speed > 0.0f ? anim.speed : 1.0f;
+        }
+    };
+
+    auto assign = [&](BlockId id, int px, int nx, int py, int ny, int pz, int nz) {
+        slot(id).faces = {px, nx, py, ny, pz, nz};
+    };
+
+    // Helper for single-texture blocks
+    auto assignAll = [&](BlockId id, const std::string& texName) {
+        int t = texture(texName);
+        assign(id, t, t, t, t, t, t);
+    };
+
+    assign(BlockId::Grass,
+           texture("grass_side"), texture("grass_side"), texture("grass_top"), texture("dirt"),
+           texture("grass_side"), texture("grass_side"));
+    assignAll(BlockId::Dirt, "dirt");
+    assignAll(BlockId::Stone, "stone");
+    assignAll(BlockId::Sand, "sand");
+    assignAll(BlockId::Gravel, "gravel");
+    assignAll(BlockId::Snow, "snow");
+
+    assignAll(BlockId::Water, "water");
+    applyAnimation(slot(BlockId::Water), "water");
+
+    assign(BlockId::OakLog, texture("oak_log"), texture("oak_log"), texture("oak_log_top"), texture("oak_log_top"), texture("oak_log"), texture("oak_log"));
+    assignAll(BlockId::OakLeaves, "oak_leaves");
+    assignAll(BlockId::OakPlanks, "oak_planks");
+    assignAll(BlockId::Glass, "glass");
+
+    assignAll(BlockId::Flower, "poppy");
+    assignAll(BlockId::Dandelion, "dandelion");
+    assignAll(BlockId::TallGrass, "tall_grass");
+    assignAll(BlockId::DeadBush, "dead_bush");
+    assignAll(BlockId::BlueOrchid, "blue_orchid");
+    assignAll(BlockId::Allium, "allium");
+    assignAll(BlockId::AzureBluet, "azure_bluet");
+    assignAll(BlockId::RedTulip, "red_tulip");
+    assignAll(BlockId::OrangeTulip, "orange_tulip");
+    assignAll(BlockId::WhiteTulip, "white_tulip");
+    assignAll(BlockId::PinkTulip, "pink_tulip");
+    assignAll(BlockId::OxeyeDaisy, "oxeye_daisy");
+    assignAll(BlockId::Cornflower, "cornflower");
+    assignAll(BlockId::LilyOfTheValley, "lily_of_the_valley");
+
+    assign(BlockId::Cactus, texture("cactus_side"), texture("cactus_side"), texture("cactus_top"), texture("cactus_bottom"), texture("cactus_side"), texture("cactus_side"));
+
+    // chunk 顶点用 8 位记录纹理层、4 位记录动画槽
+    animations_.clear();
+    for (BlockInfo& info : blocks_) {
+        for (int face : info.faces) {
+            if (face >= kChunkMaxTextureLayers) {
+                throw std::runtime_error("纹理层超出 chunk 顶点可编码的范围");
+            }
+        }
+        info.animationSlot = 0;
+        if (info.animation.animated()) {
+            if (static_cast<int>(animations_.size()) >= kMaxAnimations) {
+                throw std::runtime_error("动画方块超出 chunk 顶点可编码的动画槽数");
+            }
+            animations_.push_back(info.animation);
+            info.animationSlot = static_cast<int>(animations_.size());
+        }
+    }
 }
 
 bool BlockRegistry::occludes(BlockId id) const {
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "chunk.h"
+#include "chunk_grid.h"
+
+// BlockAccessor: 按世界坐标读取方块，记住上一次命中的 chunk。
+// 目标落在当前 chunk 或其相邻 chunk 内（整列模式 8 邻域，立方模式 26 邻域）时沿 Chunk 的相邻链接跳转，不查 ChunkGrid；
+// 只有一次跨越多个 chunk（或当前 chunk 为空）时才回退到网格查找。
+// 射线检测、碰撞这类空间上连续的访问几乎总是命中前两种情况。
+// 访问器只在一帧内短暂持有：chunk 卸载后不应继续使用旧的访问器。
+class BlockAccessor {
+public:
+    explicit BlockAccessor(const ChunkGrid& grid, const Chunk* anchor = nullptr)
+        : grid_(&grid), current_(anchor) {}
+
+    BlockId operator()(const glm::ivec3& pos) const { return block(pos); }
+
+    BlockId block(const glm::ivec3& pos) const {
+        if (!Chunk::inWorldHeight(pos.y)) {
+            return BlockId::Air;
+        }
+        const Chunk* chunk = chunkAt(pos);
+        if (!chunk) {
+            return BlockId::Air;
+        }
+        const glm::ivec3 local = pos - chunk->worldOrigin();
+        return chunk->block(local.x, local.y, local.z);
+    }
+
+    // 世界坐标 pos 所在的已加载 chunk，未加载返回 nullptr（整列模式不看 pos.y）
+    const Chunk* chunkAt(const glm::ivec3& pos) const {
+        const ChunkCoord target{floorToChunk(pos.x, Chunk::SIZE), floorToChunk(pos.z, Chunk::SIZE),
+                                Chunk::CUBIC ? floorToChunk(pos.y, Chunk::HEIGHT) : 0};
+        if (current_) {
+            const ChunkCoord coord = current_->coord();
+            const int dx = target.x - coord.x;
+            const int dy = target.y - coord.y;
+            const int dz = target.z - coord.z;
+            if (dx == 0 && dy == 0 && dz == 0) {
+                return current_;
+            }
+            if (dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1 && dz >= -1 && dz <= 1) {
+                const Chunk* next = current_->neighbor(dx, dy, dz);
+                if (next) {
+                    current_ = next;
+                }
+                return next;
+            }
+        }
+        const Chunk* found = grid_->find(target);
+        if (found) {
+            current_ = found;
+        }
+        return found;
+    }
+
+private:
+    static int floorToChunk(int v, int size) {
+        return v >= 0 ? v / size : -((-v + size - 1) / size);
+    }
+
+    const ChunkGrid* grid_;
+    mutable const Chunk* current_;
+};
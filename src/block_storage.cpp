@@ -0,0 +1,219 @@
+#include "block_storage.h"
+
+#include <utility>
+
+namespace {
+// 容纳 paletteSize (>=2) 种方块所需的最小 log2(位宽)：<=2 → 1bit，<=4 → 2bit，<=16 → 4bit，其余 8bit
+unsigned bitsShiftFor(std::size_t paletteSize) {
+    if (paletteSize <= 2) return 0;
+    if (paletteSize <= 4) return 1;
+    if (paletteSize <= 16) return 2;
+    return 3;
+}
+
+// 某一位宽下的打包参数（与 PaletteStorage 的成员一一对应）
+struct PackLayout {
+    unsigned bitsShift;
+    unsigned wordShift;
+    std::size_t entryMask;
+    std::uint64_t valueMask;
+
+    static PackLayout forShift(unsigned bitsShift) {
+        const unsigned wordShift = 6 - bitsShift;
+        return {bitsShift,
+                wordShift,
+                (std::size_t{1} << wordShift) - 1,
+                (std::uint64_t{1} << (1u << bitsShift)) - 1};
+    }
+
+    std::size_t wordCount(std::size_t size) const { return (size + entryMask) >> wordShift; }
+
+    std::uint64_t read(const std::uint64_t* words, std::size_t index) const {
+        const unsigned offset = static_cast<unsigned>(index & entryMask) << bitsShift;
+        return (words[index >> wordShift] >> offset) & valueMask;
+    }
+
+    void write(std::uint64_t* words, std::size_t index, std::uint64_t value) const {
+        std::uint64_t& word = words[index >> wordShift];
+        const unsigned offset = static_cast<unsigned>(index & entryMask) << bitsShift;
+        word = (word & ~(valueMask << offset)) | (value << offset);
+    }
+};
+} // namespace
+
+PaletteStorage::PaletteStorage(std::size_t size, BlockId fillId) : size_(size) {
+    fill(fillId);
+}
+
+PaletteStorage::PaletteStorage(const PaletteStorage& other)
+    : size_(other.size_),
+      bitsShift_(other.bitsShift_),
+      wordShift_(other.wordShift_),
+      entryMask_(other.entryMask_),
+      valueMask_(other.valueMask_),
+      paletteSize_(other.paletteSize_),
+      palette_(other.palette_),
+      slots_(other.slots_),
+      words_(other.words_) {
+    bindWords();
+}
+
+PaletteStorage& PaletteStorage::operator=(const PaletteStorage& other) {
+    if (this != &other) {
+        PaletteStorage copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+PaletteStorage::PaletteStorage(PaletteStorage&& other) noexcept
+    : size_(other.size_),
+      bitsShift_(other.bitsShift_),
+      wordShift_(other.wordShift_),
+      entryMask_(other.entryMask_),
+      valueMask_(other.valueMask_),
+      paletteSize_(other.paletteSize_),
+      palette_(other.palette_),
+      slots_(other.slots_),
+      words_(std::move(other.words_)) {
+    bindWords();
+    other.fill(other.palette_[0]);
+}
+
+PaletteStorage& PaletteStorage::operator=(PaletteStorage&& other) noexcept {
+    if (this != &other) {
+        size_ = other.size_;
+        bitsShift_ = other.bitsShift_;
+        wordShift_ = other.wordShift_;
+        entryMask_ = other.entryMask_;
+        valueMask_ = other.valueMask_;
+        paletteSize_ = other.paletteSize_;
+        palette_ = other.palette_;
+        slots_ = other.slots_;
+        words_ = std::move(other.words_);
+        bindWords();
+        other.fill(other.palette_[0]);
+    }
+    return *this;
+}
+
+void PaletteStorage::set(std::size_t index, BlockId id) {
+    const std::uint64_t slot = static_cast<std::uint64_t>(slotFor(id));
+    if (uniform()) {
+        return; // 写入的就是唯一的那种方块
+    }
+    std::uint64_t& word = words_[index >> wordShift_];
+    const unsigned offset = static_cast<unsigned>(index & entryMask_) << bitsShift_;
+    word = (word & ~(valueMask_ << offset)) | (slot << offset);
+}
+
+void PaletteStorage::fill(BlockId id) {
+    paletteSize_ = 1;
+    palette_[0] = id;
+    slots_.fill(kNoSlot);
+    slots_[static_cast<std::size_t>(id)] = 0;
+    setUniformWidth();
+    words_.clear(); // 只清空内容，容量留给下次提升位宽时复用
+    bindWords();
+}
+
+void PaletteStorage::compact() {
+    if (uniform()) {
+        return;
+    }
+
+    std::array<bool, kMaxPalette> used{};
+    for (std::size_t i = 0; i < size_; ++i) {
+        used[static_cast<std::size_t>(rawIndex(i))] = true;
+    }
+
+    std::size_t usedCount = 0;
+    for (std::size_t slot = 0; slot < paletteSize_; ++slot) {
+        if (used[slot]) ++usedCount;
+    }
+    if (usedCount == paletteSize_) {
+        return;
+    }
+    if (usedCount == 1) {
+        fill(palette_[static_cast<std::size_t>(rawIndex(0))]);
+        return;
+    }
+
+    // 旧下标 → 新下标的映射，保持调色板中原有的相对顺序（新下标不大于旧下标，可原地压紧）
+    std::array<std::uint8_t, kMaxPalette> remap{};
+    std::size_t newSize = 0;
+    for (std::size_t slot = 0; slot < paletteSize_; ++slot) {
+        if (!used[slot]) continue;
+        remap[slot] = static_cast<std::uint8_t>(newSize);
+        palette_[newSize++] = palette_[slot];
+    }
+    paletteSize_ = newSize;
+    slots_.fill(kNoSlot);
+    for (std::size_t slot = 0; slot < paletteSize_; ++slot) {
+        slots_[static_cast<std::size_t>(palette_[slot])] = static_cast<std::uint8_t>(slot);
+    }
+
+    // 就地重排：新位宽不大于旧位宽，按下标正序写入不会覆盖尚未读取的条目
+    const PackLayout from = PackLayout::forShift(bitsShift_);
+    const PackLayout to = PackLayout::forShift(bitsShiftFor(paletteSize_));
+    std::uint64_t* words = words_.data();
+    for (std::size_t i = 0; i < size_; ++i) {
+        to.write(words, i, remap[static_cast<std::size_t>(from.read(words, i))]);
+    }
+    words_.resize(to.wordCount(size_));
+    setWidth(to.bitsShift);
+    bindWords();
+}
+
+std::size_t PaletteStorage::memoryBytes() const {
+    return sizeof(*this) + words_.capacity() * sizeof(std::uint64_t);
+}
+
+int PaletteStorage::slotFor(BlockId id) {
+    std::uint8_t slot = slots_[static_cast<std::size_t>(id)];
+    if (slot != kNoSlot) {
+        return slot;
+    }
+    const std::size_t next = paletteSize_;
+    if (next > valueMask_) {
+        resize(uniform() ? 0 : bitsShift_ + 1);
+    }
+    palette_[next] = id;
+    paletteSize_ = next + 1;
+    slots_[static_cast<std::size_t>(id)] = static_cast<std::uint8_t>(next);
+    return static_cast<int>(next);
+}
+
+// 把现有下标按更宽的位宽就地重新打包（位宽只在调色板溢出时提升）
+void PaletteStorage::resize(unsigned bitsShift) {
+    const PackLayout to = PackLayout::forShift(bitsShift);
+    if (uniform()) {
+        // 从 uniform 提升：所有体素都是下标 0
+        words_.assign(to.wordCount(size_), 0);
+    } else {
+        // 新位宽更宽，按下标倒序搬移不会覆盖尚未读取的条目
+        const PackLayout from = PackLayout::forShift(bitsShift_);
+        words_.resize(to.wordCount(size_), 0);
+        std::uint64_t* words = words_.data();
+        for (std::size_t i = size_; i-- > 0;) {
+            to.write(words, i, from.read(words, i));
+        }
+    }
+    setWidth(bitsShift);
+    bindWords();
+}
+
+void PaletteStorage::setWidth(unsigned bitsShift) {
+    const PackLayout layout = PackLayout::forShift(bitsShift);
+    bitsShift_ = layout.bitsShift;
+    wordShift_ = layout.wordShift;
+    entryMask_ = layout.entryMask;
+    valueMask_ = layout.valueMask;
+}
+
+void PaletteStorage::setUniformWidth() {
+    bitsShift_ = 0;
+    wordShift_ = 63;
+    entryMask_ = 0;
+    valueMask_ = 0;
+}
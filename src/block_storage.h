@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "voxel_block.h"
+
+// PaletteStorage: 调色板 + 位压缩索引的方块存储。
+// 每个体素只保存调色板下标，位宽按不同方块种类数在 0/1/2/4/8 之间自动提升，
+// 例如只有空气和石头的区域每个体素仅占 1 bit。
+// 0 bit 即 uniform 模式：整块只有一种方块，不使用逐体素数据，
+// get() 仍走同一条无分支路径（entryMask_/valueMask_ 为 0，始终读取共享的零字）。
+// 位宽变化都在 words_ 原有容量内就地重排，fill() 也保留容量，
+// 因此被 ChunkPool 回收复用的 chunk 在稳定状态下不会再分配内存。
+class PaletteStorage {
+public:
+    explicit PaletteStorage(std::size_t size = 0, BlockId fill = BlockId::Air);
+
+    PaletteStorage(const PaletteStorage& other);
+    PaletteStorage& operator=(const PaletteStorage& other);
+    PaletteStorage(PaletteStorage&& other) noexcept;
+    PaletteStorage& operator=(PaletteStorage&& other) noexcept;
+
+    BlockId get(std::size_t index) const {
+        const std::uint64_t word = data_[index >> wordShift_];
+        const unsigned offset = static_cast<unsigned>(index & entryMask_) << bitsShift_;
+        return palette_[static_cast<std::size_t>((word >> offset) & valueMask_)];
+    }
+
+    void set(std::size_t index, BlockId id);
+
+    // 用单一方块填满全部体素（进入 uniform 模式，保留已分配的容量以便复用）
+    void fill(BlockId id);
+    // 丢弃调色板中已不再被引用的条目，必要时就地降低位宽
+    void compact();
+
+    std::size_t size() const { return size_; }
+    bool uniform() const { return valueMask_ == 0; }
+    // uniform 模式下整块的方块；非 uniform 时返回调色板首项
+    BlockId uniformId() const { return palette_[0]; }
+    int bitsPerEntry() const { return uniform() ? 0 : 1 << bitsShift_; }
+    std::size_t paletteSize() const { return paletteSize_; }
+    std::size_t memoryBytes() const;
+
+private:
+    static constexpr std::uint8_t kNoSlot = 0xFF;
+    static constexpr std::size_t kMaxPalette = static_cast<std::size_t>(BlockId::Count);
+    static constexpr std::uint64_t kZeroWord = 0;
+
+    int slotFor(BlockId id);
+    void resize(unsigned bitsShift);
+    void setWidth(unsigned bitsShift);
+    void setUniformWidth();
+    void bindWords() { data_ = uniform() ? &kZeroWord : words_.data(); }
+    std::uint64_t rawIndex(std::size_t index) const {
+        const std::uint64_t word = data_[index >> wordShift_];
+        const unsigned offset = static_cast<unsigned>(index & entryMask_) << bitsShift_;
+        return (word >> offset) & valueMask_;
+    }
+
+    std::size_t size_ = 0;
+    unsigned bitsShift_ = 0;   // log2(位宽)，0..3 对应 1/2/4/8 bit；uniform 时无意义
+    unsigned wordShift_ = 63;  // log2(每个 64 位字容纳的条目数)；uniform 时所有下标都落在字 0
+    std::size_t entryMask_ = 0;
+    std::uint64_t valueMask_ = 0;
+    const std::uint64_t* data_ = &kZeroWord; // uniform 时指向 kZeroWord，否则指向 words_
+    std::size_t paletteSize_ = 0;
+    std::array<BlockId, kMaxPalette> palette_{};
+    std::array<std::uint8_t, kMaxPalette> slots_{};
+    std::vector<std::uint64_t> words_;
+};
@@ -1,31 +1,40 @@
 #pragma once
 
-#include <functional>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "block_storage.h"
+#include "chunk_layout.h"
 #include "voxel_block.h"
 #include "mesh.h"
+#include "quad_index_buffer.h"
 #include "texture_atlas.h"
 
+// y 只在立方 chunk 模式下使用（整列模式恒为 0）；放在最后，{x, z} 的写法保持原意
 struct ChunkCoord {
     int x = 0;
     int z = 0;
+    int y = 0;
 
     bool operator==(const ChunkCoord& other) const noexcept {
-        return x == other.x && z == other.z;
+        return x == other.x && z == other.z && y == other.y;
     }
 };
 
 struct ChunkCoordHash {
     std::size_t operator()(const ChunkCoord& coord) const noexcept {
-        return (static_cast<std::size_t>(coord.x) * 73856093u) ^ (static_cast<std::size_t>(coord.z) * 19349663u);
+        return (static_cast<std::size_t>(coord.x) * 73856093u) ^ (static_cast<std::size_t>(coord.z) * 19349663u) ^
+               (static_cast<std::size_t>(coord.y) * 83492791u);
     }
 };
 
+struct ChunkMeshData;
+
 namespace std {
     template <>
     struct hash<ChunkCoord> {
@@ -37,10 +46,38 @@ namespace std {
 
 class Chunk {
 public:
-    static constexpr int SIZE = 16;
-    static constexpr int HEIGHT = 128;
-
-    explicit Chunk(ChunkCoord coord);
+    // 尺寸在编译期由 WorldLayout 决定（见 chunk_layout.h）
+    using Layout = WorldLayout;
+    static constexpr int SIZE = Layout::SIZE;
+    static constexpr int HEIGHT = Layout::HEIGHT;
+    // 立方 chunk 模式：HEIGHT 为单个 chunk 的高度，世界沿 Y 由上下相邻的 chunk 接续
+    static constexpr bool CUBIC = Layout::CUBIC;
+    // 相邻链接覆盖的 Y 偏移范围：立方模式为 -1..1，整列模式只有 0
+    static constexpr int NEIGHBOR_DY = CUBIC ? 1 : 0;
+    // 垂直方向切成 16³ 的分段，每段独立压缩；整段同一种方块时不分配逐体素数据
+    static constexpr int SECTION_SIZE = Layout::SECTION_SIZE;
+    static constexpr int SECTION_COUNT = Layout::SECTION_COUNT;
+    static constexpr std::size_t SECTION_VOLUME = Layout::SECTION_VOLUME;
+    // 每列 (x,z) 沿 Y 的占用位图由 COLUMN_WORDS 个 64 位字组成
+    static constexpr int COLUMN_WORDS = Layout::COLUMN_WORDS;
+    // 分段位掩码：bit s 对应分段 s（mesh 按分段存放，编辑只重建受影响的分段）
+    using SectionMask = std::uint32_t;
+    static_assert(SECTION_COUNT <= 32, "section masks are 32 bits wide");
+    static constexpr SectionMask ALL_SECTIONS =
+        SECTION_COUNT == 32 ? ~SectionMask{0} : (SectionMask{1} << SECTION_COUNT) - 1;
+    // 覆盖 y 闭区间 [yMin, yMax] 的分段（区间会被裁剪到世界高度内）
+    static SectionMask sectionsSpanning(int yMin, int yMax);
+    // 世界坐标 y 是否在世界高度内（立方模式没有上下限）
+    static bool inWorldHeight(int y) { return CUBIC || (y >= 0 && y < HEIGHT); }
+    // 远处 chunk 的网格细节级别：LOD n 把 2^n 格见方的体素投票合并成一格，0 为逐体素
+    static constexpr int MAX_LOD = 3;
+    static_assert(SIZE % (1 << MAX_LOD) == 0 && SECTION_SIZE % (1 << MAX_LOD) == 0,
+                  "LOD cells must tile chunks and sections exactly");
+
+    // 占用位图的种类：非空气 / 实心（碰撞）/ 不透明（遮挡相邻面）
+    enum class Occupancy { NonAir = 0, Solid = 1, Opaque = 2 };
+
+    Chunk(ChunkCoord coord, const BlockRegistry& registry);
     ~Chunk();
 
     Chunk(const Chunk&) = delete;
@@ -49,43 +86,163 @@ public:
     Chunk(Chunk&& other) noexcept;
     Chunk& operator=(Chunk&& other) noexcept;
 
+    // 供 ChunkPool 复用：换成新坐标并清空为空气，保留体素缓冲容量与 GL 句柄
+    void reset(ChunkCoord coord);
+
     BlockId block(int x, int y, int z) const;
     void setBlock(int x, int y, int z, BlockId id);
+    // 与 block 相同，但 x/z（立方模式下还有 y）越出本 chunk 至多一个 chunk 时经相邻链接读取（邻居未加载时返回 Air）
+    BlockId sample(int x, int y, int z) const;
+
+    // 相邻 chunk 的裸指针，由 World 在加载/卸载时维护：整列模式为 8 个水平邻居，
+    // 立方模式为 26 个（dy 也取 -1..1）；dx/dz 取 -1..1，不含中心，dy 超出 NEIGHBOR_DY 时为 nullptr
+    Chunk* neighbor(int dx, int dy, int dz) const {
+        return dy < -NEIGHBOR_DY || dy > NEIGHBOR_DY ? nullptr : neighbors_[neighborSlot(dx, dy, dz)];
+    }
+    Chunk* neighbor(int dx, int dz) const { return neighbor(dx, 0, dz); }
+    void setNeighbor(int dx, int dy, int dz, Chunk* chunk) { neighbors_[neighborSlot(dx, dy, dz)] = chunk; }
+    void setNeighbor(int dx, int dz, Chunk* chunk) { setNeighbor(dx, 0, dz, chunk); }
 
-    glm::ivec3 worldOrigin() const { return glm::ivec3(coord_.x * SIZE, 0, coord_.z * SIZE); }
+    glm::ivec3 worldOrigin() const { return glm::ivec3(coord_.x * SIZE, coord_.y * HEIGHT, coord_.z * SIZE); }
     ChunkCoord coord() const { return coord_; }
 
-    void buildMesh(const BlockRegistry& registry,
-                   const std::function<BlockId(const glm::ivec3&)>& sampler,
-                   const std::function<glm::vec3(const glm::vec3&, BlockId, int)>& colorSampler);
+    // 上传工作线程构建好的分段 mesh（仅主线程），只替换 mesh.sections 中的分段；
+    // revision 为拍快照时的版本，此后 chunk 又被修改过则这些分段重新标脏，等待下一轮重建。
+    // 只上传顶点，索引来自共用的 quadIndices
+    void applyMesh(const ChunkMeshData& mesh, std::uint64_t revision, QuadIndexBuffer& quadIndices);
 
-    void renderSolid() const;
+    // 依次绘制各个非空分段。eye 非空时按各分段包围盒跳过整体背对 eye 的面方向，
+    // 返回实际提交的不透明四边形数
+    std::size_t renderSolid(const glm::vec3* eye = nullptr) const;
     void renderAlpha() const;
-
-    bool dirty() const { return dirty_; }
-    void markDirty() { dirty_ = true; }
+    // 水面网格：与玻璃等分开绘制，调用方可关闭背面剔除，让水下也能看到水面
+    void renderLiquid() const;
+    // 当前 mesh 中不透明四边形的总数
+    std::size_t solidQuadCount() const;
+    // 一次实例化绘制本 chunk 的全部植物十字面片（需 billboard.vert）
+    void renderBillboards() const;
+    std::size_t billboardCount() const { return static_cast<std::size_t>(billboards_.instanceCount); }
+
+    bool dirty() const { return dirtySections_ != 0; }
+    // 等待重建的分段
+    SectionMask dirtySections() const { return dirtySections_; }
+    // 派发构建任务时取走脏分段（之后的修改会重新标脏）
+    SectionMask takeDirtySections() {
+        const SectionMask taken = dirtySections_;
+        dirtySections_ = 0;
+        return taken;
+    }
+    // 方块内容或相邻 chunk 变化后调用，同时推进 revision；不带参数时整个 chunk 重建
+    void markDirty(SectionMask sections = ALL_SECTIONS);
+    // 下一次构建使用的细节级别；改变时整个 chunk 标脏（LOD 网格总是整 chunk 重建）
+    int lod() const { return lod_; }
+    void setLod(int lod);
+    // 每次方块内容变化都会递增；reset 后取全局新值，避免与回收前的旧任务混淆
+    std::uint64_t revision() const { return revision_; }
+    // 已有一个构建任务在工作线程中，结果上传前不再重复派发
+    bool meshPending() const { return meshPending_; }
+    void setMeshPending(bool pending) { meshPending_ = pending; }
 
     bool empty() const { return empty_; }
+    // 当前 mesh 的世界空间包围盒：水平为整个 chunk，垂直收紧到非空气层 [meshMinY_, meshMaxY_)
+    glm::vec3 meshBoundsMin() const { return glm::vec3(worldOrigin()) + glm::vec3(0.0f, static_cast<float>(meshMinY_), 0.0f); }
+    glm::vec3 meshBoundsMax() const {
+        return glm::vec3(worldOrigin()) + glm::vec3(static_cast<float>(SIZE), static_cast<float>(meshMaxY_), static_cast<float>(SIZE));
+    }
+
+    // 回收调色板中已无引用的方块种类（地形生成结束后调用，尽量降低位宽，
+    // 只剩一种方块的分段会退化为 uniform）
+    void compactStorage();
+    void fillSection(int section, BlockId id);
+    const PaletteStorage& section(int index) const { return sections_[static_cast<std::size_t>(index)]; }
+    bool sectionUniform(int index, BlockId id) const {
+        const PaletteStorage& s = section(index);
+        return s.uniform() && s.uniformId() == id;
+    }
+    std::size_t storageBytes() const;
+    // 占用位图、高度图、邻居链接等固定开销，加上各分段植物实例的 CPU 副本
+    std::size_t metadataBytes() const;
+    // 当前上传到 GPU 的各分段 VBO 与植物实例缓冲字节数（回收复用时缓冲仍保留；共用的索引缓冲不计在内）
+    std::size_t meshGpuBytes() const;
+    // 最近一次构建 mesh 时所在线程常驻临时缓冲的字节数
+    std::size_t meshScratchBytes() const { return meshScratchBytes_; }
+
+    // 列 (x,z) 中最高的实心方块 y（chunk 局部坐标）；整列没有实心方块时返回 -1（由 setBlock 增量维护）
+    int surfaceHeight(int x, int z) const { return heightmap_[columnIndex(x, z)]; }
+    // 局部坐标闭区间 [min, max] 内是否不含指定种类的方块（区间会被裁剪到 chunk 内）
+    bool isRangeEmpty(const glm::ivec3& min, const glm::ivec3& max, Occupancy kind = Occupancy::Solid) const;
+    // 列 (x,z) 第 word 个 64 位占用字，bit i 对应 y = word*64 + i
+    std::uint64_t columnBits(Occupancy kind, int x, int z, int word) const {
+        return columnMasks_[static_cast<std::size_t>(kind)][columnIndex(x, z) * COLUMN_WORDS + static_cast<std::size_t>(word)];
+    }
+    // 整个 chunk 某一种占用位图，供 MeshInput 拍快照
+    const std::array<std::uint64_t, SIZE * SIZE * COLUMN_WORDS>& occupancy(Occupancy kind) const {
+        return columnMasks_[static_cast<std::size_t>(kind)];
+    }
 
 private:
     struct MeshBuffers {
         GLuint vao = 0;
         GLuint vbo = 0;
-        GLuint ebo = 0;
+        GLenum indexType = GL_UNSIGNED_SHORT;
         GLsizei indexCount = 0;
+        std::array<GLsizei, 6> faceQuads{}; // 不透明 mesh 中各面方向连续区间的四边形数
+        std::size_t gpuBytes = 0;
         bool ready = false;
     };
 
-    void uploadMesh(const std::vector<RenderVertex>& vertices,
-                    const std::vector<unsigned int>& indices,
-                    MeshBuffers& dst);
+    struct SectionBuffers {
+        MeshBuffers solid;
+        MeshBuffers alpha;
+        MeshBuffers liquid;
+    };
+
+    // 整个 chunk 的植物实例缓冲：每个实例画 kBillboardQuads 个四边形
+    struct BillboardBuffers {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLenum indexType = GL_UNSIGNED_SHORT;
+        GLsizei instanceCount = 0;
+        std::size_t gpuBytes = 0;
+    };
+
+    void uploadMesh(const std::vector<ChunkVertex>& vertices, QuadIndexBuffer& quadIndices, MeshBuffers& dst);
+    // 把各分段的实例依次拼接后整体重新上传
+    void uploadBillboards(QuadIndexBuffer& quadIndices);
     void destroyMesh(MeshBuffers& mesh);
+    static void drawMesh(const MeshBuffers& mesh);
+    // 只绘制 faces（bit f 对应面方向 f）中的区间，相邻区间合并后一次 glMultiDrawElements；返回四边形数
+    static std::size_t drawFaces(const MeshBuffers& mesh, unsigned faces);
+
+    static std::size_t columnIndex(int x, int z) { return static_cast<std::size_t>(z * SIZE + x); }
+    static constexpr int NEIGHBOR_COUNT = 9 * (2 * NEIGHBOR_DY + 1) - 1;
+    // 3x3（立方模式 3x3x3）邻域去掉中心后的下标 0..NEIGHBOR_COUNT-1
+    static std::size_t neighborSlot(int dx, int dy, int dz) {
+        constexpr int center = NEIGHBOR_DY * 9 + 4;
+        const int slot = ((dy + NEIGHBOR_DY) * 3 + (dz + 1)) * 3 + (dx + 1);
+        return static_cast<std::size_t>(slot > center ? slot - 1 : slot);
+    }
+    void updateOccupancy(int x, int y, int z, BlockId id);
+    void refreshHeight(int x, int z);
+    void clearOccupancy();
 
     ChunkCoord coord_{};
-    std::vector<BlockId> blocks_;
-    bool dirty_ = true;
+    const BlockRegistry* registry_ = nullptr;
+    std::uint64_t revision_ = 0;
+    std::array<PaletteStorage, SECTION_COUNT> sections_;
+    std::array<std::array<std::uint64_t, SIZE * SIZE * COLUMN_WORDS>, 3> columnMasks_{};
+    std::array<std::int16_t, SIZE * SIZE> heightmap_{};
+    std::array<Chunk*, NEIGHBOR_COUNT> neighbors_{};
+    SectionMask dirtySections_ = ALL_SECTIONS;
+    bool meshPending_ = false;
+    int lod_ = 0;
     bool empty_ = false;
-
-    MeshBuffers solid_{};
-    MeshBuffers alpha_{};
+    int meshMinY_ = 0;
+    int meshMaxY_ = HEIGHT;
+    std::size_t meshScratchBytes_ = 0;
+
+    std::array<SectionBuffers, SECTION_COUNT> sectionMeshes_{};
+    // 只重建部分分段时，其余分段的实例要从这里取回，才能拼成整个 chunk 的实例缓冲
+    std::array<std::vector<BillboardInstance>, SECTION_COUNT> billboardSections_;
+    BillboardBuffers billboards_;
 };
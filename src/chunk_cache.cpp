@@ -0,0 +1,130 @@
+#include "chunk_cache.h"
+
+#include <iterator>
+#include <utility>
+
+namespace {
+constexpr std::size_t kSectionVolume = Chunk::SECTION_VOLUME;
+static_assert(kSectionVolume <= 0xFFFF, "run length must fit in 16 bits");
+
+// 每个游程 3 字节：方块 id + 16 位小端长度；每个分段的游程长度之和恰为 kSectionVolume
+void appendRun(std::vector<std::uint8_t>& out, BlockId id, std::size_t length) {
+    out.push_back(static_cast<std::uint8_t>(id));
+    out.push_back(static_cast<std::uint8_t>(length & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(length >> 8));
+}
+
+// 粗略估计 list 节点 + 哈希表节点的额外开销
+constexpr std::size_t kEntryOverhead = 64;
+} // namespace
+
+ChunkCache::ChunkCache(std::size_t budgetBytes) {
+    setBudget(budgetBytes);
+}
+
+void ChunkCache::setBudget(std::size_t budgetBytes) {
+    stats_.budget = budgetBytes;
+    trim();
+}
+
+void ChunkCache::store(const Chunk& chunk) {
+    if (stats_.budget == 0) {
+        return;
+    }
+
+    // 按分段存储顺序（y → z → x）编码，uniform 分段只有一个游程
+    scratch_.clear();
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        const PaletteStorage& section = chunk.section(s);
+        if (section.uniform()) {
+            appendRun(scratch_, section.uniformId(), kSectionVolume);
+            continue;
+        }
+        BlockId current = section.get(0);
+        std::size_t length = 1;
+        for (std::size_t i = 1; i < kSectionVolume; ++i) {
+            BlockId id = section.get(i);
+            if (id == current) {
+                ++length;
+                continue;
+            }
+            appendRun(scratch_, current, length);
+            current = id;
+            length = 1;
+        }
+        appendRun(scratch_, current, length);
+    }
+
+    auto found = index_.find(chunk.coord());
+    if (found != index_.end()) {
+        erase(found->second);
+    }
+    lru_.push_front(Entry{chunk.coord(), std::vector<std::uint8_t>(scratch_.begin(), scratch_.end())});
+    index_[chunk.coord()] = lru_.begin();
+    stats_.bytes += entryBytes(lru_.front());
+    stats_.entries = lru_.size();
+    ++stats_.stores;
+    trim();
+}
+
+bool ChunkCache::restore(Chunk& chunk) {
+    auto found = index_.find(chunk.coord());
+    if (found == index_.end()) {
+        ++stats_.misses;
+        return false;
+    }
+
+    const std::vector<std::uint8_t>& data = found->second->data;
+    std::size_t offset = 0;
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        std::size_t index = 0;
+        while (index < kSectionVolume) {
+            const BlockId id = static_cast<BlockId>(data[offset]);
+            const std::size_t length = static_cast<std::size_t>(data[offset + 1]) |
+                                       (static_cast<std::size_t>(data[offset + 2]) << 8);
+            offset += 3;
+            if (length == kSectionVolume) {
+                chunk.fillSection(s, id);
+            } else if (id != BlockId::Air) {
+                // chunk 刚 reset 为空气，只需写回非空气游程
+                for (std::size_t i = index; i < index + length; ++i) {
+                    const int x = static_cast<int>(i % Chunk::SIZE);
+                    const int z = static_cast<int>((i / Chunk::SIZE) % Chunk::SIZE);
+                    const int y = s * Chunk::SECTION_SIZE + static_cast<int>(i / (Chunk::SIZE * Chunk::SIZE));
+                    chunk.setBlock(x, y, z, id);
+                }
+            }
+            index += length;
+        }
+    }
+
+    erase(found->second);
+    ++stats_.hits;
+    return true;
+}
+
+void ChunkCache::clear() {
+    lru_.clear();
+    index_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+}
+
+std::size_t ChunkCache::entryBytes(const Entry& entry) {
+    return sizeof(Entry) + kEntryOverhead + entry.data.capacity();
+}
+
+void ChunkCache::erase(EntryList::iterator it) {
+    stats_.bytes -= entryBytes(*it);
+    index_.erase(it->coord);
+    lru_.erase(it);
+    stats_.entries = lru_.size();
+}
+
+// 从最久未访问的一端淘汰，直到回到预算以内
+void ChunkCache::trim() {
+    while (!lru_.empty() && stats_.bytes > stats_.budget) {
+        erase(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk.h"
+
+// ChunkCache: 卸载 chunk 的冷存储层。
+// 离开加载范围的 chunk 以逐分段 RLE（方块 id + 游程长度）压缩后放进按字节预算管理的 LRU，
+// 玩家折返时直接解压回 chunk，不必重新跑 FBM 地形生成，玩家的修改也随之保留。
+// 超出预算时从最久未访问的一端淘汰（被淘汰的 chunk 下次加载时重新生成）。
+class ChunkCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;      // restore 命中
+        std::size_t misses = 0;    // restore 未命中（需要重新生成）
+        std::size_t stores = 0;    // 写入次数
+        std::size_t evictions = 0; // 因超出预算被淘汰的条目数
+        std::size_t entries = 0;   // 当前缓存的 chunk 数
+        std::size_t bytes = 0;     // 当前占用字节（压缩数据 + 条目开销）
+        std::size_t budget = 0;    // 字节预算
+    };
+
+    explicit ChunkCache(std::size_t budgetBytes = 0);
+
+    // 调整预算（变小时立即淘汰到预算以内）；预算为 0 表示不缓存
+    void setBudget(std::size_t budgetBytes);
+
+    // 压缩并缓存 chunk 的方块数据（同坐标的旧条目会被替换）
+    void store(const Chunk& chunk);
+    // 命中时把方块数据解压进 chunk（chunk 需已 reset 到该坐标）并移除条目，返回 true
+    bool restore(Chunk& chunk);
+    void clear();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Entry {
+        ChunkCoord coord{};
+        std::vector<std::uint8_t> data;
+    };
+    using EntryList = std::list<Entry>;
+
+    static std::size_t entryBytes(const Entry& entry);
+    void erase(EntryList::iterator it);
+    void trim();
+
+    EntryList lru_; // 头部为最近写入
+    std::unordered_map<ChunkCoord, EntryList::iterator> index_;
+    std::vector<std::uint8_t> scratch_; // 编码缓冲，复用容量
+    Stats stats_{};
+};
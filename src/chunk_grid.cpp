@@ -0,0 +1,60 @@
+#include "chunk_grid.h"
+
+#include <utility>
+
+namespace {
+// 窗口边长向上取整到 2 的幂，保证窗口内任意两个坐标不会落到同一槽位
+int windowWidth(int radius) {
+    int width = 1;
+    while (width < 2 * radius + 1) {
+        width <<= 1;
+    }
+    return width;
+}
+} // namespace
+
+ChunkGrid::ChunkGrid(int radius, int verticalRadius) {
+    resize(radius, verticalRadius);
+}
+
+void ChunkGrid::resize(int radius, int verticalRadius) {
+    radius_ = radius < 0 ? 0 : radius;
+    verticalRadius_ = verticalRadius < 0 ? 0 : verticalRadius;
+    width_ = windowWidth(radius_);
+    mask_ = width_ - 1;
+    const int layers = windowWidth(verticalRadius_);
+    verticalMask_ = layers - 1;
+    count_ = 0;
+    slots_.clear();
+    slots_.resize(static_cast<std::size_t>(width_) * static_cast<std::size_t>(width_) * static_cast<std::size_t>(layers));
+}
+
+std::unique_ptr<Chunk> ChunkGrid::insert(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) {
+        return nullptr;
+    }
+    Slot& slot = slots_[slotIndex(chunk->coord())];
+    std::unique_ptr<Chunk> evicted = std::move(slot.chunk);
+    if (!evicted) {
+        ++count_;
+    }
+    slot.coord = chunk->coord();
+    slot.chunk = std::move(chunk);
+    return evicted;
+}
+
+std::unique_ptr<Chunk> ChunkGrid::remove(const ChunkCoord& coord) {
+    Slot& slot = slots_[slotIndex(coord)];
+    if (!slot.chunk || !(slot.coord == coord)) {
+        return nullptr;
+    }
+    --count_;
+    return std::move(slot.chunk);
+}
+
+void ChunkGrid::clear() {
+    for (Slot& slot : slots_) {
+        slot.chunk.reset();
+    }
+    count_ = 0;
+}
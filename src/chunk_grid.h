@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "chunk.h"
+
+// ChunkGrid: 以 (coord mod window) 为下标的环形（toroidal）chunk 网格。
+// 窗口边长取 >= 2*radius+1 的 2 的幂，下标只需一次按位与即可定位；
+// 立方 chunk 模式下 Y 方向同样按 verticalRadius 取窗口，整列模式 verticalRadius 为 0，只有一层；
+// 玩家移动时不需要重新哈希或搬移数据——新 chunk 直接写入其槽位，
+// 槽位里残留的旧 chunk 必然已经在窗口之外，会被顶替出来交还给调用方。
+class ChunkGrid {
+public:
+    explicit ChunkGrid(int radius = 0, int verticalRadius = 0);
+
+    // 重新设定半径（会清空网格）
+    void resize(int radius, int verticalRadius = 0);
+
+    int radius() const { return radius_; }
+    int verticalRadius() const { return verticalRadius_; }
+    int width() const { return width_; }
+    std::size_t size() const { return count_; }
+
+    Chunk* find(const ChunkCoord& coord) const {
+        const Slot& slot = slots_[slotIndex(coord)];
+        return slot.coord == coord ? slot.chunk.get() : nullptr;
+    }
+
+    // 放入 chunk；若槽位被其它坐标占用，返回被顶替的旧 chunk
+    std::unique_ptr<Chunk> insert(std::unique_ptr<Chunk> chunk);
+    std::unique_ptr<Chunk> remove(const ChunkCoord& coord);
+    void clear();
+
+    // 按槽位顺序（内存连续）遍历所有已加载 chunk
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : slots_) {
+            if (slot.chunk) {
+                fn(*slot.chunk);
+            }
+        }
+    }
+
+    // 把满足 pred 的 chunk 从网格中取出并交给 sink（例如归还到 ChunkPool），遍历期间不分配内存
+    template <typename Pred, typename Sink>
+    void evictIf(Pred&& pred, Sink&& sink) {
+        for (Slot& slot : slots_) {
+            if (slot.chunk && pred(*slot.chunk)) {
+                --count_;
+                sink(std::move(slot.chunk));
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        ChunkCoord coord{};
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    std::size_t slotIndex(const ChunkCoord& coord) const {
+        // 二补码下 & mask 对负坐标同样得到 [0, width) 的环形下标
+        const int x = coord.x & mask_;
+        const int z = coord.z & mask_;
+        const int y = coord.y & verticalMask_;
+        return static_cast<std::size_t>((y * width_ + z) * width_ + x);
+    }
+
+    int radius_ = 0;
+    int verticalRadius_ = 0;
+    int width_ = 1;
+    int mask_ = 0;
+    int verticalMask_ = 0;
+    std::size_t count_ = 0;
+    std::vector<Slot> slots_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+// 世界高度在编译期确定（CMake 选项 MYCRAFT_WORLD_HEIGHT，可选 128/256/384），
+// 默认 128 与原来的硬编码值一致，不引入任何运行期开销。
+#ifndef MYCRAFT_WORLD_HEIGHT
+#define MYCRAFT_WORLD_HEIGHT 128
+#endif
+
+// 立方 chunk 模式（CMake 选项 MYCRAFT_CUBIC_CHUNKS）：chunk 为 16³，沿 Y 也按 chunk 流式加载，
+// 世界没有高度上限；此时 MYCRAFT_WORLD_HEIGHT 只决定地形的纵向缩放。默认关闭，仍为整列 chunk。
+#ifndef MYCRAFT_CUBIC_CHUNKS
+#define MYCRAFT_CUBIC_CHUNKS 0
+#endif
+
+// ChunkLayout: chunk 的尺寸参数。所有派生常量都是 constexpr，
+// 网格构建、地形生成和存储代码通过 Chunk::HEIGHT 等常量在编译期按所选布局展开。
+// Cubic 为真时 chunk 在 Y 方向也有上下邻居，Height 只是一个 chunk 的高度；
+// TerrainHeight 为地形按其缩放的世界高度
+template <int Size, int Height, int SectionSize = 16, bool Cubic = false, int TerrainHeight = Height>
+struct ChunkLayout {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "chunk width must be a power of two");
+    static_assert(SectionSize > 0 && Height % SectionSize == 0, "height must be a whole number of sections");
+    static_assert(64 % SectionSize == 0, "a section must not straddle two 64-bit column words");
+
+    static constexpr int SIZE = Size;
+    static constexpr int HEIGHT = Height;
+    static constexpr int SECTION_SIZE = SectionSize;
+    static constexpr int SECTION_COUNT = Height / SectionSize;
+    static constexpr int COLUMN_WORDS = (Height + 63) / 64;
+    static constexpr std::size_t SECTION_VOLUME = static_cast<std::size_t>(SectionSize) * Size * Size;
+    static constexpr bool CUBIC = Cubic;
+
+    // 地形纵向缩放：以 128 高为基准，山地抬升、雪线、云层按比例放大，海平面与基础地表不变
+    static constexpr float TERRAIN_SCALE = static_cast<float>(TerrainHeight) / 128.0f;
+};
+
+#if MYCRAFT_CUBIC_CHUNKS
+using WorldLayout = ChunkLayout<16, 16, 16, true, MYCRAFT_WORLD_HEIGHT>;
+#else
+using WorldLayout = ChunkLayout<16, MYCRAFT_WORLD_HEIGHT>;
+#endif
@@ -0,0 +1,1038 @@
+#include "chunk_mesher.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+#include "biome.h"
+#include "bit_utils.h"
+
+namespace {
+constexpr glm::ivec3 faceOffsets[6] = {
+    {1, 0, 0},
+    {-1, 0, 0},
+    {0, 1, 0},
+    {0, -1, 0},
+    {0, 0, 1},
+    {0, 0, -1},
+};
+
+constexpr std::array<glm::vec3, 4> faceVertices[6] = {
+    std::array<glm::vec3, 4>{glm::vec3(1, 0, 1), glm::vec3(1, 0, 0), glm::vec3(1, 1, 0), glm::vec3(1, 1, 1)}, // +X (Right)
+    std::array<glm::vec3, 4>{glm::vec3(0, 0, 0), glm::vec3(0, 0, 1), glm::vec3(0, 1, 1), glm::vec3(0, 1, 0)}, // -X (Left)
+    std::array<glm::vec3, 4>{glm::vec3(0, 1, 1), glm::vec3(1, 1, 1), glm::vec3(1, 1, 0), glm::vec3(0, 1, 0)}, // +Y (Top)
+    std::array<glm::vec3, 4>{glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(1, 0, 1), glm::vec3(0, 0, 1)}, // -Y (Bottom)
+    std::array<glm::vec3, 4>{glm::vec3(0, 0, 1), glm::vec3(1, 0, 1), glm::vec3(1, 1, 1), glm::vec3(0, 1, 1)}, // +Z (Front)
+    std::array<glm::vec3, 4>{glm::vec3(1, 0, 0), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0), glm::vec3(1, 1, 0)}, // -Z (Back)
+};
+
+constexpr std::array<glm::vec2, 4> baseUV = {
+    glm::vec2(0.0f, 0.0f),
+    glm::vec2(1.0f, 0.0f),
+    glm::vec2(1.0f, 1.0f),
+    glm::vec2(0.0f, 1.0f),
+};
+
+static_assert(Chunk::SIZE * kChunkPositionScale < (1 << 9), "x/z must fit the 9-bit position fields");
+static_assert(Chunk::HEIGHT * kChunkPositionScale < (1 << 13), "y must fit the 13-bit position field");
+static_assert(Chunk::SIZE < (1 << 5) && Chunk::HEIGHT < (1 << 10), "greedy quad sizes must fit the UV fields");
+
+// Packs one vertex in the ChunkVertex layout (see mesh.h). local is chunk-local and on
+// the 1/kChunkPositionScale grid, uv counts whole blocks.
+ChunkVertex packVertex(const glm::vec3& local,
+                       const glm::ivec2& uv,
+                       int face,
+                       int occlusion,
+                       const BlockInfo& info,
+                       int layer,
+                       const BlockTint& tint) {
+    auto fixedPoint = [](float value) {
+        return static_cast<std::uint32_t>(std::lround(value * static_cast<float>(kChunkPositionScale)));
+    };
+    auto quantize = [](float value, float scale, std::uint32_t maxValue) {
+        const long steps = std::lround(std::max(value, 0.0f) * scale);
+        return std::min(static_cast<std::uint32_t>(steps), maxValue);
+    };
+    ChunkVertex vertex{};
+    vertex.position = fixedPoint(local.x) | fixedPoint(local.y) << 9 | fixedPoint(local.z) << 22 |
+                      static_cast<std::uint32_t>(tint.biome) << 31;
+    vertex.surface = static_cast<std::uint32_t>(uv.x) | static_cast<std::uint32_t>(uv.y) << 5 |
+                     static_cast<std::uint32_t>(face) << 15 | static_cast<std::uint32_t>(occlusion) << 18 |
+                     static_cast<std::uint32_t>(info.animationSlot) << 20 | quantize(info.material, 8.0f, 15u) << 24 |
+                     quantize(info.emission, 15.0f, 15u) << 28;
+    vertex.color = quantize(tint.color.r, 255.0f, 255u) | quantize(tint.color.g, 255.0f, 255u) << 8 |
+                   quantize(tint.color.b, 255.0f, 255u) << 16 | static_cast<std::uint32_t>(layer) << 24;
+    return vertex;
+}
+
+// Quads are stored as 4 consecutive vertices; the shared QuadIndexBuffer supplies
+// the 0,1,2,2,3,0 triangles at draw time
+void addQuad(std::vector<ChunkVertex>& vertices, const std::array<ChunkVertex, 4>& corners) {
+    vertices.insert(vertices.end(), corners.begin(), corners.end());
+}
+
+// Greedy Meshing Helper Struct
+struct MaskEntry {
+    BlockId id;
+    int normal; // Normal index for back-face culling logic if needed, or just boolean
+    bool visible;
+    std::uint8_t ao; // faceOcclusion of the face; only faces with identical AO merge
+    
+    // For comparing if we can merge
+    bool operator==(const MaskEntry& other) const {
+        return visible == other.visible && id == other.id && ao == other.ao;
+    }
+    
+    bool operator!=(const MaskEntry& other) const {
+        return !(*this == other);
+    }
+};
+
+// Sweep axis d and in-slice axes u/v per face; u/v follow the faceVertices winding
+struct FaceAxes {
+    int d;
+    int u;
+    int v;
+};
+
+constexpr FaceAxes kFaceAxes[6] = {
+    {0, 2, 1}, // +X: slice Z-Y
+    {0, 2, 1}, // -X
+    {1, 0, 2}, // +Y: slice X-Z
+    {1, 0, 2}, // -Y
+    {2, 0, 1}, // +Z: slice X-Y
+    {2, 0, 1}, // -Z
+};
+
+constexpr int axisSize(int axis) {
+    return axis == 1 ? Chunk::HEIGHT : Chunk::SIZE;
+}
+
+// The 8 blocks around a face's neighbour cell, as (du, dv) steps along the face's u/v
+// axes; bit i of a ring mask is set when kAoRing[i] occludes
+constexpr int kAoRing[8][2] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+using AoTable = std::array<std::array<std::uint8_t, 256>, 6>;
+
+// Ring mask -> per-corner occlusion for each face, packed as 2 bits per faceVertices
+// corner (corner k in bits 2k..2k+1, each the number of occluders 0..3 that chunk.vert
+// turns into the AO term)
+const AoTable& aoTable() {
+    static const AoTable table = [] {
+        AoTable result{};
+        auto ringBit = [](int du, int dv) {
+            for (int i = 0; i < 8; ++i) {
+                if (kAoRing[i][0] == du && kAoRing[i][1] == dv) return i;
+            }
+            return 0;
+        };
+        for (int face = 0; face < 6; ++face) {
+            for (int ring = 0; ring < 256; ++ring) {
+                std::uint8_t packed = 0;
+                for (int k = 0; k < 4; ++k) {
+                    const glm::vec3& corner = faceVertices[face][k];
+                    const int su = corner[kFaceAxes[face].u] > 0.5f ? 1 : -1;
+                    const int sv = corner[kFaceAxes[face].v] > 0.5f ? 1 : -1;
+                    const bool side1 = (ring >> ringBit(su, 0)) & 1;
+                    const bool side2 = (ring >> ringBit(0, sv)) & 1;
+                    const bool diagonal = (ring >> ringBit(su, sv)) & 1;
+                    // Both sides blocked hides the corner block entirely
+                    const int occlusion = (side1 && side2) ? 3 : int(side1) + int(side2) + int(diagonal);
+                    packed = static_cast<std::uint8_t>(packed | occlusion << (2 * k));
+                }
+                result[static_cast<std::size_t>(face)][static_cast<std::size_t>(ring)] = packed;
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+// Packed per-corner occlusion of one block face (blockPos chunk-local), sampled from the
+// padded snapshot
+std::uint8_t faceOcclusion(const MeshInput& input, const glm::ivec3& blockPos, int face) {
+    const int uAxis = kFaceAxes[face].u;
+    const int vAxis = kFaceAxes[face].v;
+    const glm::ivec3 base = blockPos + faceOffsets[face];
+    unsigned ring = 0;
+    for (int i = 0; i < 8; ++i) {
+        glm::ivec3 p = base;
+        p[uAxis] += kAoRing[i][0];
+        p[vAxis] += kAoRing[i][1];
+        ring |= static_cast<unsigned>(input.occludes(p.x, p.y, p.z)) << i;
+    }
+    return aoTable()[static_cast<std::size_t>(face)][ring];
+}
+
+inline int cornerOcclusion(std::uint8_t packed, int corner) {
+    return (packed >> (2 * corner)) & 3;
+}
+
+// One merged face: anchor block (chunk-local, lowest u/v corner) plus its extent in u/v
+struct GreedyQuad {
+    int face;
+    int pos[3];
+    int width;
+    int height;
+    BlockId id;
+    std::uint8_t ao; // faceOcclusion shared by every face in the quad
+};
+
+using LayerBits = std::array<std::uint64_t, Chunk::COLUMN_WORDS>;
+
+inline bool layerSet(const LayerBits& layers, int y) {
+    return ((layers[static_cast<std::size_t>(y / 64)] >> (y % 64)) & 1u) != 0;
+}
+
+// Layers covered by a section mask (sections never straddle a column word)
+LayerBits sectionLayers(Chunk::SectionMask sections) {
+    constexpr int PER_WORD = 64 / Chunk::SECTION_SIZE;
+    constexpr std::uint64_t SECTION_BITS =
+        Chunk::SECTION_SIZE == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << Chunk::SECTION_SIZE) - 1;
+    LayerBits layers{};
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        if ((sections >> s) & 1u) {
+            layers[static_cast<std::size_t>(s / PER_WORD)] |= SECTION_BITS << ((s % PER_WORD) * Chunk::SECTION_SIZE);
+        }
+    }
+    return layers;
+}
+
+using ColumnBits = std::array<std::uint64_t, Chunk::COLUMN_WORDS>;
+
+// Per-thread build buffers (see threadScratch). They keep their capacity between builds,
+// so once a thread has meshed its largest chunk no further build needs to allocate.
+struct MeshScratch {
+    std::vector<GreedyQuad> quads;
+    // Binary path
+    std::vector<ColumnBits> faces;
+    std::vector<ColumnBits> translucent;
+    std::vector<std::uint32_t> rows;
+    std::vector<std::uint8_t> aoCells;
+    // Reference path
+    std::vector<MaskEntry> mask;
+    // LOD path
+    std::vector<BlockId> lodGrid;
+    std::vector<std::pair<BlockId, int>> lodVotes;
+    std::vector<BlockId> lodMask;
+
+    static constexpr std::size_t kBuffers = 9;
+
+    // Capacity of each buffer in bytes, in declaration order
+    std::array<std::size_t, kBuffers> capacities() const {
+        return {quads.capacity() * sizeof(GreedyQuad),
+                faces.capacity() * sizeof(ColumnBits),
+                translucent.capacity() * sizeof(ColumnBits),
+                rows.capacity() * sizeof(std::uint32_t),
+                aoCells.capacity(),
+                mask.capacity() * sizeof(MaskEntry),
+                lodGrid.capacity() * sizeof(BlockId),
+                lodVotes.capacity() * sizeof(std::pair<BlockId, int>),
+                lodMask.capacity() * sizeof(BlockId)};
+    }
+};
+
+MeshScratch& threadScratch() {
+    thread_local MeshScratch scratch;
+    return scratch;
+}
+
+// Capacities of the output vectors, to tell which ones had to grow during a build
+using OutputCapacities = std::array<std::size_t, Chunk::SECTION_COUNT * 4>;
+
+OutputCapacities outputCapacities(const ChunkMeshData& out) {
+    OutputCapacities capacities{};
+    for (std::size_t s = 0; s < out.sectionMeshes.size(); ++s) {
+        const SectionMeshData& section = out.sectionMeshes[s];
+        capacities[s * 4] = section.solidVertices.capacity();
+        capacities[s * 4 + 1] = section.alphaVertices.capacity();
+        capacities[s * 4 + 2] = section.liquidVertices.capacity();
+        capacities[s * 4 + 3] = section.billboards.capacity();
+    }
+    return capacities;
+}
+
+template <std::size_t N>
+std::size_t grownCount(const std::array<std::size_t, N>& before, const std::array<std::size_t, N>& after) {
+    std::size_t grown = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        grown += after[i] != before[i] ? 1 : 0;
+    }
+    return grown;
+}
+
+// Greedy quads grow along y only up to the end of the anchor's section, so every
+// quad belongs to exactly one section mesh
+inline int sectionEnd(int y) {
+    return (y / Chunk::SECTION_SIZE + 1) * Chunk::SECTION_SIZE;
+}
+
+void emitGreedyQuad(const BlockRegistry& registry, const GreedyQuad& quad, ChunkMeshData& out) {
+    const int face = quad.face;
+    const int uAxis = kFaceAxes[face].u;
+    const int vAxis = kFaceAxes[face].v;
+    const BlockInfo& info = registry.info(quad.id);
+    const glm::vec3 base(quad.pos[0], quad.pos[1], quad.pos[2]);
+
+    // The vertex tint only depends on block and face; the biome part is sampled per
+    // fragment in block.frag, so a merged quad still shows the colour of every column it covers
+    const BlockTint tint = blockTint(registry, quad.id, face);
+
+    // Stretch the unit face template: corners on the far side of u/v move by width-1 / height-1.
+    // Every face in the quad has the same per-corner AO, so stretching keeps it exact.
+    std::array<ChunkVertex, 4> corners;
+    for (int k = 0; k < 4; ++k) {
+        const glm::vec3& v = faceVertices[face][k];
+        glm::vec3 corner = base + v;
+        if (v[uAxis] > 0.5f) {
+            corner[uAxis] += static_cast<float>(quad.width - 1);
+        }
+        if (v[vAxis] > 0.5f) {
+            corner[vAxis] += static_cast<float>(quad.height - 1);
+        }
+        // UVs run 0..width / 0..height so the texture tiles across the merged face
+        const glm::vec2& unitUV = baseUV[static_cast<std::size_t>(k)];
+        const glm::ivec2 uv(unitUV.x > 0.5f ? quad.width : 0, unitUV.y > 0.5f ? quad.height : 0);
+        corners[static_cast<std::size_t>(k)] =
+            packVertex(corner, uv, face, cornerOcclusion(quad.ao, k), info, info.faces[face], tint);
+    }
+    // The shared index pattern splits along corners 0-2. When that diagonal is the darker
+    // one, start the quad at corner 1 instead so the split runs 1-3 and the AO gradient
+    // stays symmetric (same winding, so culling is unaffected)
+    if (cornerOcclusion(quad.ao, 0) + cornerOcclusion(quad.ao, 2) > cornerOcclusion(quad.ao, 1) + cornerOcclusion(quad.ao, 3)) {
+        std::rotate(corners.begin(), corners.begin() + 1, corners.end());
+    }
+
+    SectionMeshData& section = out.sectionMeshes[static_cast<std::size_t>(quad.pos[1] / Chunk::SECTION_SIZE)];
+    if (info.liquid) {
+        addQuad(section.liquidVertices, corners);
+    } else {
+        addQuad(info.transparent ? section.alphaVertices : section.solidVertices, corners);
+    }
+}
+
+// Reference path: fills a MaskEntry grid per slice, sampling every voxel and its
+// neighbour, then merges by comparing entries. Kept to cross-check the binary path.
+// layerAny holds only the layers of the sections being built.
+void extractQuadsReference(const MeshInput& input,
+                           const BlockRegistry& registry,
+                           int yBegin,
+                           int yEnd,
+                           const LayerBits& layerAny,
+                           const LayerBits& layerOpaque,
+                           MeshScratch& scratch) {
+    constexpr int SIZE = Chunk::SIZE;
+    constexpr int HEIGHT = Chunk::HEIGHT;
+    std::vector<MaskEntry>& mask = scratch.mask;
+    std::vector<GreedyQuad>& quads = scratch.quads;
+
+    for (int face = 0; face < 6; ++face) {
+        const int dAxis = kFaceAxes[face].d;
+        const int uAxis = kFaceAxes[face].u;
+        const int vAxis = kFaceAxes[face].v;
+        const int dSize = axisSize(dAxis);
+        const int uSize = axisSize(uAxis);
+        const int vSize = axisSize(vAxis);
+
+        // Only the non-air Y range is swept: slices for +/-Y, mask rows for the side faces.
+        // Rows outside it stay default (invisible) in the mask.
+        const int dBegin = dAxis == 1 ? yBegin : 0;
+        const int dEnd = dAxis == 1 ? yEnd : dSize;
+        const int vBegin = vAxis == 1 ? yBegin : 0;
+        const int vEnd = vAxis == 1 ? yEnd : vSize;
+
+        mask.assign(static_cast<std::size_t>(uSize * vSize), MaskEntry{});
+
+        // q[0], q[1], q[2] is the cursor position. q[dAxis] = i
+        int q[3] = {0, 0, 0};
+        const glm::ivec3 faceDir = faceOffsets[face];
+
+        for (int i = dBegin; i < dEnd; ++i) {
+            q[dAxis] = i;
+            const int neighborD = i + faceDir[dAxis];
+
+            if (dAxis == 1) {
+                // Whole Y slice hidden: empty, or opaque against an opaque layer
+                if (!layerSet(layerAny, i)) continue;
+                if (layerSet(layerOpaque, i) && neighborD >= 0 && neighborD < HEIGHT &&
+                    layerSet(layerOpaque, neighborD)) {
+                    continue;
+                }
+            }
+
+            // 1. Populate the mask for this slice
+            std::size_t n = static_cast<std::size_t>(vBegin * uSize);
+            for (int v = vBegin; v < vEnd; ++v) {
+                q[vAxis] = v;
+                if (dAxis != 1) {
+                    // Row in an empty layer, or in a fully opaque layer whose neighbour
+                    // row is inside this chunk (and therefore opaque too): nothing visible
+                    if (!layerSet(layerAny, v) ||
+                        (layerSet(layerOpaque, v) && neighborD >= 0 && neighborD < SIZE)) {
+                        for (int u = 0; u < uSize; ++u) {
+                            mask[n++] = {BlockId::Air, face, false, 0};
+                        }
+                        continue;
+                    }
+                }
+                for (int u = 0; u < uSize; ++u) {
+                    q[uAxis] = u;
+                    BlockId id = input.block(q[0], q[1], q[2]);
+                    bool visible = false;
+                    std::uint8_t ao = 0;
+                    // Billboards are built in a separate pass and stay invisible here
+                    if (id != BlockId::Air && !registry.info(id).billboard) {
+                        BlockId neighborId = input.block(q[0] + faceDir.x, q[1] + faceDir.y, q[2] + faceDir.z);
+                        // A block next to the same block shows no face in between (water bodies, glass panes)
+                        bool occluded = registry.occludes(neighborId) || neighborId == id;
+                        visible = !occluded;
+                    }
+                    if (visible) {
+                        ao = faceOcclusion(input, glm::ivec3(q[0], q[1], q[2]), face);
+                    }
+                    mask[n++] = {id, face, visible, ao};
+                }
+            }
+
+            // 2. Greedy merge on the mask
+            n = static_cast<std::size_t>(vBegin * uSize);
+            for (int v = vBegin; v < vEnd; ++v) {
+                for (int u = 0; u < uSize; ++u, ++n) {
+                    if (!mask[n].visible) {
+                        continue;
+                    }
+                    int width = 1;
+                    while (u + width < uSize && mask[n + static_cast<std::size_t>(width)] == mask[n]) {
+                        width++;
+                    }
+                    int height = 1;
+                    bool done = false;
+                    const int vLimit = vAxis == 1 ? std::min(vEnd, sectionEnd(v)) : vEnd;
+                    for (; v + height < vLimit; ++height) {
+                        for (int k = 0; k < width; ++k) {
+                            if (mask[n + static_cast<std::size_t>(k + height * uSize)] != mask[n]) {
+                                done = true;
+                                break;
+                            }
+                        }
+                        if (done) break;
+                    }
+
+                    GreedyQuad quad{face, {0, 0, 0}, width, height, mask[n].id, mask[n].ao};
+                    quad.pos[dAxis] = i;
+                    quad.pos[uAxis] = u;
+                    quad.pos[vAxis] = v;
+                    quads.push_back(quad);
+
+                    // Mark covered
+                    for (int h = 0; h < height; ++h) {
+                        for (int w = 0; w < width; ++w) {
+                            mask[n + static_cast<std::size_t>(w + h * uSize)].visible = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Opaque bits of column (x, z), word w, shifted by dy layers so bit b holds layer
+// w*64+b+dy. Bits shifted in past the chunk's top or bottom come from the cube
+// above or below; in column mode nothing is there
+std::uint64_t shiftedOpaque(const MeshInput& input, int x, int z, int w, int dy) {
+    constexpr int WORDS = Chunk::COLUMN_WORDS;
+    const std::uint64_t* bits = input.opaqueColumn(x, z);
+    const std::size_t word = static_cast<std::size_t>(w);
+    if (dy > 0) {
+        const std::uint64_t carry = w + 1 < WORDS ? bits[word + 1] << 63
+                                  : input.opaqueAbove(x, z) ? std::uint64_t{1} << ((Chunk::HEIGHT - 1) % 64) : 0;
+        return (bits[word] >> 1) | carry;
+    }
+    if (dy < 0) {
+        const std::uint64_t carry = w > 0 ? bits[word - 1] >> 63 : (input.opaqueBelow(x, z) ? 1 : 0);
+        return (bits[word] << 1) | carry;
+    }
+    return bits[word];
+}
+
+// Binary path: visible faces are computed 64 layers at a time from the padded
+// Opaque column masks (a face is visible unless the neighbour occludes it; translucent
+// blocks are then checked one by one against a neighbour of the same block), scattered
+// into one bit row per (slice, v) and merged with
+// count-trailing-zeros scans, comparing block and faceOcclusion. Produces the same
+// quads in the same order as the reference path.
+void extractQuadsBinary(const MeshInput& input, const BlockRegistry& registry, const LayerBits& layers, MeshScratch& scratch) {
+    constexpr int SIZE = Chunk::SIZE;
+    constexpr int WORDS = Chunk::COLUMN_WORDS;
+    static_assert(SIZE <= 32, "a slice row is one 32-bit mask");
+    using Occupancy = Chunk::Occupancy;
+    std::vector<std::uint32_t>& rows = scratch.rows;
+    std::vector<std::uint8_t>& aoCells = scratch.aoCells;
+    std::vector<GreedyQuad>& quads = scratch.quads;
+
+    // Blocks that emit greedy faces (non-air, not billboards, in the requested layers) and the
+    // non-occluding ones among them (water, glass); every entry is overwritten below, so stale
+    // contents from the previous build are harmless
+    std::vector<ColumnBits>& faces = scratch.faces;
+    std::vector<ColumnBits>& translucent = scratch.translucent;
+    faces.resize(static_cast<std::size_t>(SIZE * SIZE));
+    translucent.resize(static_cast<std::size_t>(SIZE * SIZE));
+    for (int z = 0; z < SIZE; ++z) {
+        for (int x = 0; x < SIZE; ++x) {
+            const std::size_t column = static_cast<std::size_t>(z * SIZE + x);
+            for (int w = 0; w < WORDS; ++w) {
+                const std::uint64_t nonAir = input.columnBits(Occupancy::NonAir, x, z, w) & layers[static_cast<std::size_t>(w)];
+                const std::uint64_t clear = nonAir & ~input.columnBits(Occupancy::Opaque, x, z, w);
+                std::uint64_t faceBits = nonAir;
+                // Only non-occluding blocks can be billboards
+                for (std::uint64_t rest = clear; rest; rest &= rest - 1) {
+                    const int bit = lowestBit(rest);
+                    if (registry.info(input.block(x, w * 64 + bit, z)).billboard) {
+                        faceBits &= ~(std::uint64_t{1} << bit);
+                    }
+                }
+                faces[column][static_cast<std::size_t>(w)] = faceBits;
+                translucent[column][static_cast<std::size_t>(w)] = faceBits & clear;
+            }
+        }
+    }
+
+    for (int face = 0; face < 6; ++face) {
+        const int dAxis = kFaceAxes[face].d;
+        const int uAxis = kFaceAxes[face].u;
+        const int vAxis = kFaceAxes[face].v;
+        const int dSize = axisSize(dAxis);
+        const int uSize = axisSize(uAxis);
+        const int vSize = axisSize(vAxis);
+        const glm::ivec3 faceDir = faceOffsets[face];
+
+        rows.assign(static_cast<std::size_t>(dSize * vSize), 0u);
+        auto row = [&](int d, int v) -> std::uint32_t& { return rows[static_cast<std::size_t>(d * vSize + v)]; };
+        // faceOcclusion of each visible face, written in step 1 and only read for set row bits
+        aoCells.resize(static_cast<std::size_t>(dSize * vSize * SIZE));
+        auto aoCell = [&](int d, int v, int u) -> std::uint8_t& {
+            return aoCells[static_cast<std::size_t>((d * vSize + v) * SIZE + u)];
+        };
+        const std::array<std::uint8_t, 256>& aoLookup = aoTable()[static_cast<std::size_t>(face)];
+        // Ring sample i sits at column offset (ringX, ringZ) and layer offset ringY from the face's block
+        int ringX[8];
+        int ringY[8];
+        int ringZ[8];
+        for (int i = 0; i < 8; ++i) {
+            glm::ivec3 offset = faceDir;
+            offset[uAxis] += kAoRing[i][0];
+            offset[vAxis] += kAoRing[i][1];
+            ringX[i] = offset.x;
+            ringY[i] = offset.y;
+            ringZ[i] = offset.z;
+        }
+
+        // 1. Visible face bits per column, scattered into slice rows
+        for (int z = 0; z < SIZE; ++z) {
+            for (int x = 0; x < SIZE; ++x) {
+                const std::size_t column = static_cast<std::size_t>(z * SIZE + x);
+                // The chunk's own column for +/-Y, the neighbouring (possibly border) column otherwise
+                for (int w = 0; w < WORDS; ++w) {
+                    const std::size_t word = static_cast<std::size_t>(w);
+                    const std::uint64_t neighbor = shiftedOpaque(input, x + faceDir.x, z + faceDir.z, w, faceDir.y);
+                    std::uint64_t visible = faces[column][word] & ~neighbor;
+                    // Water against water, glass against glass: the face is inside one body
+                    for (std::uint64_t rest = visible & translucent[column][word]; rest; rest &= rest - 1) {
+                        const int bit = lowestBit(rest);
+                        const int y = w * 64 + bit;
+                        if (input.block(x + faceDir.x, y + faceDir.y, z + faceDir.z) == input.block(x, y, z)) {
+                            visible &= ~(std::uint64_t{1} << bit);
+                        }
+                    }
+                    if (!visible) continue;
+                    // The 8 AO samples of all 64 layers, shifted so bit b lines up with layer w*64+b
+                    std::uint64_t ring[8];
+                    std::uint64_t anyRing = 0;
+                    for (int i = 0; i < 8; ++i) {
+                        ring[i] = shiftedOpaque(input, x + ringX[i], z + ringZ[i], w, ringY[i]);
+                        anyRing |= ring[i];
+                    }
+                    for (; visible; visible &= visible - 1) {
+                        const int bit = lowestBit(visible);
+                        const int q[3] = {x, w * 64 + bit, z};
+                        row(q[dAxis], q[vAxis]) |= std::uint32_t{1} << q[uAxis];
+                        // Most exposed faces have nothing around them: skip the gather
+                        unsigned ringBits = 0;
+                        if ((anyRing >> bit) & 1u) {
+                            for (int i = 0; i < 8; ++i) {
+                                ringBits |= static_cast<unsigned>((ring[i] >> bit) & 1u) << i;
+                            }
+                        }
+                        aoCell(q[dAxis], q[vAxis], q[uAxis]) = aoLookup[ringBits];
+                    }
+                }
+            }
+        }
+
+        // 2. Greedy merge: runs along u via trailing-zero scans, then grow along v
+        //    while the next row holds the same run of the same block
+        for (int d = 0; d < dSize; ++d) {
+            int cell[3] = {0, 0, 0};
+            cell[dAxis] = d;
+            auto blockAt = [&](int u, int v) {
+                cell[uAxis] = u;
+                cell[vAxis] = v;
+                return input.block(cell[0], cell[1], cell[2]);
+            };
+            // Faces merge only with the same block and the same corner AO
+            auto sameFace = [&](int u, int v, BlockId id, std::uint8_t ao) {
+                return aoCell(d, v, u) == ao && blockAt(u, v) == id;
+            };
+            for (int v = 0; v < vSize; ++v) {
+                std::uint32_t& bits = row(d, v);
+                while (bits) {
+                    const int u = lowestBit(bits);
+                    const BlockId id = blockAt(u, v);
+                    const std::uint8_t ao = aoCell(d, v, u);
+                    int width = 1;
+                    while (u + width < uSize && ((bits >> (u + width)) & 1u) && sameFace(u + width, v, id, ao)) {
+                        width++;
+                    }
+                    const std::uint32_t run = static_cast<std::uint32_t>(((std::uint64_t{1} << width) - 1) << u);
+                    int height = 1;
+                    const int vLimit = vAxis == 1 ? sectionEnd(v) : vSize;
+                    for (; v + height < vLimit; ++height) {
+                        if ((row(d, v + height) & run) != run) break;
+                        bool same = true;
+                        for (int k = 0; k < width && same; ++k) {
+                            same = sameFace(u + k, v + height, id, ao);
+                        }
+                        if (!same) break;
+                    }
+                    for (int h = 0; h < height; ++h) {
+                        row(d, v + h) &= ~run;
+                    }
+
+                    GreedyQuad quad{face, {0, 0, 0}, width, height, id, ao};
+                    quad.pos[dAxis] = d;
+                    quad.pos[uAxis] = u;
+                    quad.pos[vAxis] = v;
+                    quads.push_back(quad);
+                }
+            }
+        }
+    }
+}
+
+// LOD path: votes every s*s*s cell (s = 2^lod) down to one block, then greedy-merges
+// the coarse grid face by face. Quads come back in voxel units, anchored on the cell's
+// outer voxel layer, so emitGreedyQuad places them like full-resolution quads.
+// layerAny lets all-air cell layers skip the vote.
+void extractQuadsLod(const MeshInput& input, const BlockRegistry& registry, const LayerBits& layerAny, MeshScratch& scratch) {
+    constexpr int SIZE = Chunk::SIZE;
+    constexpr int HEIGHT = Chunk::HEIGHT;
+    const int s = 1 << input.lod();
+    const int cells[3] = {SIZE / s, HEIGHT / s, SIZE / s};
+    auto cellIndex = [&](const int (&c)[3]) {
+        return static_cast<std::size_t>((c[1] * cells[2] + c[2]) * cells[0] + c[0]);
+    };
+
+    // 1. Vote: a cell is filled when at least half of its voxels are (non-plant) blocks,
+    //    and takes the block most columns show on top, so surfaces keep their grass/sand
+    std::vector<BlockId>& grid = scratch.lodGrid;
+    std::vector<std::pair<BlockId, int>>& votes = scratch.lodVotes;
+    std::vector<GreedyQuad>& quads = scratch.quads;
+    grid.assign(static_cast<std::size_t>(cells[0] * cells[1] * cells[2]), BlockId::Air);
+    votes.reserve(static_cast<std::size_t>(s * s));
+    for (int cy = 0; cy < cells[1]; ++cy) {
+        bool anyLayer = false;
+        for (int y = cy * s; y < (cy + 1) * s; ++y) {
+            anyLayer = anyLayer || layerSet(layerAny, y);
+        }
+        if (!anyLayer) {
+            continue;
+        }
+        for (int cz = 0; cz < cells[2]; ++cz) {
+            for (int cx = 0; cx < cells[0]; ++cx) {
+                int filled = 0;
+                votes.clear();
+                for (int z = cz * s; z < (cz + 1) * s; ++z) {
+                    for (int x = cx * s; x < (cx + 1) * s; ++x) {
+                        BlockId top = BlockId::Air;
+                        for (int y = (cy + 1) * s - 1; y >= cy * s; --y) {
+                            const BlockId id = input.block(x, y, z);
+                            if (id == BlockId::Air || registry.info(id).billboard) {
+                                continue;
+                            }
+                            ++filled;
+                            if (top == BlockId::Air) {
+                                top = id;
+                            }
+                        }
+                        if (top == BlockId::Air) {
+                            continue;
+                        }
+                        auto vote = std::find_if(votes.begin(), votes.end(), [&](const auto& v) { return v.first == top; });
+                        if (vote == votes.end()) {
+                            votes.emplace_back(top, 1);
+                        } else {
+                            ++vote->second;
+                        }
+                    }
+                }
+                if (filled * 2 >= s * s * s) {
+                    const int c[3] = {cx, cy, cz};
+                    grid[cellIndex(c)] = std::max_element(votes.begin(), votes.end(), [](const auto& a, const auto& b) {
+                                             return a.second < b.second;
+                                         })->first;
+                }
+            }
+        }
+    }
+
+    // A face across the chunk border is hidden only when the neighbour's voxels right
+    // behind it (and, for solids, behind the cell above too) all cover it. Those voxels
+    // are real only for a LOD 0 neighbour, which then keeps its own border faces; a
+    // coarse neighbour's border reads as air, so both sides keep their faces as skirts
+    auto borderHidden = [&](int face, const int (&c)[3], BlockId id) {
+        const int dAxis = kFaceAxes[face].d;
+        const int uAxis = kFaceAxes[face].u;
+        const int vAxis = kFaceAxes[face].v;
+        const int vCells = vAxis != 1 || registry.info(id).liquid ? 1 : 2;
+        int q[3];
+        q[dAxis] = faceOffsets[face][dAxis] > 0 ? axisSize(dAxis) : -1;
+        for (int v = c[vAxis] * s; v < std::min((c[vAxis] + vCells) * s, axisSize(vAxis)); ++v) {
+            q[vAxis] = v;
+            for (int u = c[uAxis] * s; u < (c[uAxis] + 1) * s; ++u) {
+                q[uAxis] = u;
+                const BlockId neighbor = input.block(q[0], q[1], q[2]);
+                if (neighbor != id && !registry.occludes(neighbor)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // 2. Greedy merge per face over the coarse grid, same face order and axes as the full mesher
+    std::vector<BlockId>& mask = scratch.lodMask;
+    for (int face = 0; face < 6; ++face) {
+        const int dAxis = kFaceAxes[face].d;
+        const int uAxis = kFaceAxes[face].u;
+        const int vAxis = kFaceAxes[face].v;
+        const int step = faceOffsets[face][dAxis];
+        const int uSize = cells[uAxis];
+        const int vSize = cells[vAxis];
+        mask.assign(static_cast<std::size_t>(uSize * vSize), BlockId::Air);
+
+        for (int i = 0; i < cells[dAxis]; ++i) {
+            int c[3];
+            c[dAxis] = i;
+            std::size_t n = 0;
+            for (int v = 0; v < vSize; ++v) {
+                c[vAxis] = v;
+                for (int u = 0; u < uSize; ++u, ++n) {
+                    c[uAxis] = u;
+                    const BlockId id = grid[cellIndex(c)];
+                    mask[n] = BlockId::Air;
+                    if (id == BlockId::Air) {
+                        continue;
+                    }
+                    const int next = i + step;
+                    bool visible;
+                    if (next >= 0 && next < cells[dAxis]) {
+                        int nc[3] = {c[0], c[1], c[2]};
+                        nc[dAxis] = next;
+                        const BlockId neighbor = grid[cellIndex(nc)];
+                        // Same rule as the full mesher: occluders and matching blocks hide the face
+                        visible = neighbor != id && !registry.occludes(neighbor);
+                    } else if (dAxis == 1 && !Chunk::CUBIC) {
+                        // Nothing is ever seen from below the world; the sky above is open
+                        visible = next >= cells[1];
+                    } else {
+                        visible = !borderHidden(face, c, id);
+                    }
+                    if (visible) {
+                        mask[n] = id;
+                    }
+                }
+            }
+
+            n = 0;
+            for (int v = 0; v < vSize; ++v) {
+                for (int u = 0; u < uSize; ++u, ++n) {
+                    const BlockId id = mask[n];
+                    if (id == BlockId::Air) {
+                        continue;
+                    }
+                    int width = 1;
+                    while (u + width < uSize && mask[n + static_cast<std::size_t>(width)] == id) {
+                        ++width;
+                    }
+                    int height = 1;
+                    bool done = false;
+                    for (; v + height < vSize; ++height) {
+                        for (int k = 0; k < width; ++k) {
+                            if (mask[n + static_cast<std::size_t>(k + height * uSize)] != id) {
+                                done = true;
+                                break;
+                            }
+                        }
+                        if (done) break;
+                    }
+                    for (int h = 0; h < height; ++h) {
+                        std::fill_n(mask.begin() + static_cast<std::ptrdiff_t>(n + static_cast<std::size_t>(h * uSize)), width, BlockId::Air);
+                    }
+
+                    // Anchor on the voxel layer the face sits on: the far side of the cell for +d faces
+                    GreedyQuad quad{face, {0, 0, 0}, width * s, height * s, id, 0};
+                    quad.pos[dAxis] = step > 0 ? i * s + s - 1 : i * s;
+                    quad.pos[uAxis] = u * s;
+                    quad.pos[vAxis] = v * s;
+                    quads.push_back(quad);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+MeshInput::MeshInput(const Chunk& chunk, Chunk::SectionMask sections)
+    : coord_(chunk.coord()),
+      // A coarse cell spans up to 8 layers and the cell above, so LOD meshes always read the whole chunk
+      sections_(chunk.lod() > 0 ? Chunk::ALL_SECTIONS : sections & Chunk::ALL_SECTIONS),
+      lod_(chunk.lod()),
+      revision_(chunk.revision()),
+      voxels_(static_cast<std::size_t>(PADDED_SIZE * PADDED_SIZE * PADDED_HEIGHT), BlockId::Air),
+      paddedOpaque_(static_cast<std::size_t>(PADDED_SIZE * PADDED_SIZE * Chunk::COLUMN_WORDS), 0) {
+    constexpr int SIZE = Chunk::SIZE;
+    // Per axis: the one-voxel border on the low side comes from the neighbour's last
+    // slice, the interior from the chunk itself, the high side from the neighbour's first.
+    // Cubic chunks also take the layers just below and above from the chunks there
+    if (Chunk::CUBIC) {
+        paddedEdges_.assign(static_cast<std::size_t>(PADDED_SIZE * PADDED_SIZE), 0);
+    }
+    for (int dy = -Chunk::NEIGHBOR_DY; dy <= Chunk::NEIGHBOR_DY; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const Chunk* source = (dx == 0 && dy == 0 && dz == 0) ? &chunk : chunk.neighbor(dx, dy, dz);
+                if (!source) {
+                    continue;
+                }
+                // An edge neighbour at LOD > 0 draws its voted cells, not these voxels, so
+                // its border is left as air: every face along it stays as a skirt and no
+                // seam depends on which cells the vote kept. Only LOD 0 borders cull
+                if (source != &chunk && std::abs(dx) + std::abs(dy) + std::abs(dz) == 1 && source->lod() > 0) {
+                    continue;
+                }
+                const int dstX0 = dx < 0 ? -1 : (dx > 0 ? SIZE : 0);
+                const int dstZ0 = dz < 0 ? -1 : (dz > 0 ? SIZE : 0);
+                const int srcX0 = dx < 0 ? SIZE - 1 : 0;
+                const int srcZ0 = dz < 0 ? SIZE - 1 : 0;
+                const int width = dx == 0 ? SIZE : 1;
+                const int depth = dz == 0 ? SIZE : 1;
+                if (dy == 0) {
+                    copyColumns(*source, dstX0, dstZ0, srcX0, srcZ0, width, depth);
+                } else {
+                    copyEdgeLayer(*source, dy, dstX0, dstZ0, srcX0, srcZ0, width, depth);
+                }
+            }
+        }
+    }
+    for (std::size_t kind = 0; kind < columnMasks_.size(); ++kind) {
+        columnMasks_[kind] = chunk.occupancy(static_cast<Chunk::Occupancy>(kind));
+    }
+}
+
+void MeshInput::copyColumns(const Chunk& source, int dstX0, int dstZ0, int srcX0, int srcZ0, int width, int depth) {
+    for (int dz = 0; dz < depth; ++dz) {
+        for (int dx = 0; dx < width; ++dx) {
+            std::uint64_t* dst = &paddedOpaque_[static_cast<std::size_t>((dstZ0 + dz + 1) * PADDED_SIZE + (dstX0 + dx + 1)) *
+                                                Chunk::COLUMN_WORDS];
+            for (int w = 0; w < Chunk::COLUMN_WORDS; ++w) {
+                dst[w] = source.columnBits(Chunk::Occupancy::Opaque, srcX0 + dx, srcZ0 + dz, w);
+            }
+        }
+    }
+    // Block ids are read for the requested sections plus one layer above and below them
+    auto requested = [&](int s) { return s >= 0 && s < Chunk::SECTION_COUNT && ((sections_ >> s) & 1u); };
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        const bool below = requested(s - 1);
+        const bool above = requested(s + 1);
+        if (!requested(s) && !below && !above) {
+            continue;
+        }
+        const PaletteStorage& section = source.section(s);
+        const int y0 = s * Chunk::SECTION_SIZE;
+        // Of a section next to a requested one only its bottom and/or top layer is needed
+        const int lyBegin = requested(s) || below ? 0 : Chunk::SECTION_SIZE - 1;
+        const int lyEnd = requested(s) || above ? Chunk::SECTION_SIZE : 1;
+        for (int ly = lyBegin; ly < lyEnd; ++ly) {
+            for (int dz = 0; dz < depth; ++dz) {
+                BlockId* row = &voxels_[paddedIndex(dstX0, y0 + ly, dstZ0 + dz)];
+                if (section.uniform()) {
+                    std::fill(row, row + width, section.uniformId());
+                    continue;
+                }
+                const std::size_t src = static_cast<std::size_t>((ly * Chunk::SIZE + srcZ0 + dz) * Chunk::SIZE + srcX0);
+                for (int dx = 0; dx < width; ++dx) {
+                    row[dx] = section.get(src + static_cast<std::size_t>(dx));
+                }
+            }
+        }
+    }
+}
+
+void buildChunkMesh(const MeshInput& input, const BlockRegistry& registry, ChunkMeshData& out, GreedyMesher mesher) {
+    constexpr int SIZE = Chunk::SIZE;
+    constexpr int HEIGHT = Chunk::HEIGHT;
+    constexpr int COLUMN_WORDS = Chunk::COLUMN_WORDS;
+    using Occupancy = Chunk::Occupancy;
+
+    MeshScratch& scratch = threadScratch();
+    const std::array<std::size_t, MeshScratch::kBuffers> scratchBefore = scratch.capacities();
+    const OutputCapacities outputBefore = outputCapacities(out);
+
+    // A recycled out keeps its vector capacity; only the contents are reset
+    out.sections = input.sections();
+    out.lod = input.lod();
+    for (SectionMeshData& section : out.sectionMeshes) {
+        section.solidVertices.clear();
+        section.solidFaceQuads.fill(0);
+        section.alphaVertices.clear();
+        section.liquidVertices.clear();
+        section.billboards.clear();
+    }
+
+    // Layer summaries folded from the column occupancy masks: a layer with no
+    // non-air voxel emits nothing, and a fully opaque layer can only show faces
+    // toward a layer that is not fully opaque or across the chunk border.
+    LayerBits layerAny{};
+    LayerBits layerOpaque{};
+    layerOpaque.fill(~std::uint64_t{0});
+    for (int z = 0; z < SIZE; ++z) {
+        for (int x = 0; x < SIZE; ++x) {
+            for (int w = 0; w < COLUMN_WORDS; ++w) {
+                layerAny[static_cast<std::size_t>(w)] |= input.columnBits(Occupancy::NonAir, x, z, w);
+                layerOpaque[static_cast<std::size_t>(w)] &= input.columnBits(Occupancy::Opaque, x, z, w);
+            }
+        }
+    }
+    // [yBegin, yEnd) bounds the non-air layers
+    int yBegin = HEIGHT;
+    int yEnd = 0;
+    for (int w = 0; w < COLUMN_WORDS; ++w) {
+        const std::uint64_t bits = layerAny[static_cast<std::size_t>(w)];
+        if (bits) {
+            yBegin = std::min(yBegin, w * 64 + lowestBit(bits));
+            yEnd = w * 64 + highestBit(bits) + 1;
+        }
+    }
+
+    // Faces are only extracted in the requested sections; the bounds above still cover the whole chunk
+    const LayerBits layers = sectionLayers(out.sections);
+    std::vector<GreedyQuad>& quads = scratch.quads;
+    quads.clear();
+    if (input.lod() > 0) {
+        extractQuadsLod(input, registry, layerAny, scratch);
+    } else if (mesher == GreedyMesher::Binary) {
+        extractQuadsBinary(input, registry, layers, scratch);
+    } else {
+        LayerBits requested = layerAny;
+        for (std::size_t w = 0; w < requested.size(); ++w) {
+            requested[w] &= layers[w];
+        }
+        extractQuadsReference(input, registry, yBegin, yEnd, requested, layerOpaque, scratch);
+    }
+    // Both extractors emit quads face by face, so every section's solid vertices come out
+    // as six contiguous per-direction ranges; only their lengths need recording
+    std::array<std::size_t, Chunk::SECTION_COUNT> alphaQuads{};
+    std::array<std::size_t, Chunk::SECTION_COUNT> liquidQuads{};
+    for (const GreedyQuad& quad : quads) {
+        const BlockInfo& info = registry.info(quad.id);
+        const std::size_t section = static_cast<std::size_t>(quad.pos[1] / Chunk::SECTION_SIZE);
+        if (info.liquid) {
+            ++liquidQuads[section];
+        } else if (info.transparent) {
+            ++alphaQuads[section];
+        } else {
+            ++out.sectionMeshes[section].solidFaceQuads[static_cast<std::size_t>(quad.face)];
+        }
+    }
+    // Size the vertex buffers from the quads instead of a fixed guess: a
+    // mostly buried chunk emits far fewer than the guess, and an oversized fresh
+    // allocation costs more in page faults than building its quads. A recycled
+    // out only grows when this chunk needs more than any it was used for before.
+    for (std::size_t section = 0; section < out.sectionMeshes.size(); ++section) {
+        const std::array<std::uint32_t, 6>& faceQuads = out.sectionMeshes[section].solidFaceQuads;
+        const std::size_t solidQuads = std::accumulate(faceQuads.begin(), faceQuads.end(), std::size_t{0});
+        out.sectionMeshes[section].solidVertices.reserve(solidQuads * 4);
+        out.sectionMeshes[section].alphaVertices.reserve(alphaQuads[section] * 4);
+        out.sectionMeshes[section].liquidVertices.reserve(liquidQuads[section] * 4);
+    }
+    for (const GreedyQuad& quad : quads) {
+        emitGreedyQuad(registry, quad, out);
+    }
+
+    // Also build Billboards (Cross models) - passed over in greedy loop.
+    // Billboards are non-air but not solid, so only those column bits are visited.
+    // LOD meshes have none: plants are distance-culled well before a chunk drops to LOD.
+    const LayerBits plantLayers = input.lod() == 0 ? layers : LayerBits{};
+    for (int z = 0; z < SIZE; ++z) {
+        for (int x = 0; x < SIZE; ++x) {
+            for (int w = 0; w < COLUMN_WORDS; ++w) {
+                std::uint64_t candidates = input.columnBits(Occupancy::NonAir, x, z, w) &
+                                           ~input.columnBits(Occupancy::Solid, x, z, w) & plantLayers[static_cast<std::size_t>(w)];
+                for (; candidates; candidates &= candidates - 1) {
+                    const int y = w * 64 + lowestBit(candidates);
+                    BlockId id = input.block(x, y, z);
+                    const BlockInfo& info = registry.info(id);
+                    if (!info.billboard) continue;
+                    // Use face 2 (Top) for billboards to get biome tint if applicable
+                    const BlockTint billboardTint = blockTint(registry, id, 2);
+                    const glm::vec3 base(static_cast<float>(x) + 0.5f, static_cast<float>(y), static_cast<float>(z) + 0.5f);
+                    // One instance per plant; billboard.vert expands it into the two crossed quads
+                    SectionMeshData& section = out.sectionMeshes[static_cast<std::size_t>(y / Chunk::SECTION_SIZE)];
+                    section.billboards.push_back(
+                        packVertex(base, glm::ivec2(0), kChunkBillboardFace, 0, info, info.faces[2], billboardTint));
+                }
+            }
+        }
+    }
+
+    // Bounds come from the whole chunk's occupancy, so a partial rebuild still reports them
+    const bool anyLayer = yBegin < yEnd;
+    out.minY = anyLayer ? yBegin : 0;
+    out.maxY = anyLayer ? yEnd : 0;
+    const std::array<std::size_t, MeshScratch::kBuffers> scratchAfter = scratch.capacities();
+    out.scratchBytes = std::accumulate(scratchAfter.begin(), scratchAfter.end(), std::size_t{0});
+    out.allocations = grownCount(scratchBefore, scratchAfter) + grownCount(outputBefore, outputCapacities(out));
+}
+
+ChunkMeshData buildChunkMesh(const MeshInput& input, const BlockRegistry& registry, GreedyMesher mesher) {
+    ChunkMeshData out;
+    buildChunkMesh(input, registry, out, mesher);
+    return out;
+}
+
+void MeshInput::copyEdgeLayer(const Chunk& source, int dy, int dstX0, int dstZ0, int srcX0, int srcZ0, int width, int depth) {
+    const int srcY = dy < 0 ? Chunk::HEIGHT - 1 : 0;
+    const int dstY = dy < 0 ? -1 : Chunk::HEIGHT;
+    const std::uint8_t edgeBit = dy < 0 ? kEdgeBelow : kEdgeAbove;
+    const PaletteStorage& section = source.section(srcY / Chunk::SECTION_SIZE);
+    const int ly = srcY % Chunk::SECTION_SIZE;
+    for (int dz = 0; dz < depth; ++dz) {
+        for (int dx = 0; dx < width; ++dx) {
+            const std::uint64_t bits = source.columnBits(Chunk::Occupancy::Opaque, srcX0 + dx, srcZ0 + dz, srcY / 64);
+            if ((bits >> (srcY % 64)) & 1u) {
+                paddedEdges_[edgeIndex(dstX0 + dx, dstZ0 + dz)] |= edgeBit;
+            }
+        }
+        BlockId* row = &voxels_[paddedIndex(dstX0, dstY, dstZ0 + dz)];
+        if (section.uniform()) {
+            std::fill(row, row + width, section.uniformId());
+            continue;
+        }
+        const std::size_t src = static_cast<std::size_t>((ly * Chunk::SIZE + srcZ0 + dz) * Chunk::SIZE + srcX0);
+        for (int dx = 0; dx < width; ++dx) {
+            row[dx] = section.get(src + static_cast<std::size_t>(dx));
+        }
+    }
+}
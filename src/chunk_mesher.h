@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "chunk.h"
+#include "mesh.h"
+
+// MeshInput: 构建 mesh 所需数据的只读快照。
+// 在主线程把 chunk 连同四周一格的邻居方块拷进一个 (SIZE+2)×(HEIGHT+2)×(SIZE+2) 的连续数组
+// （上下各多一层空气），同样范围的 Opaque 列位图一并拷贝；构建时只读这份数据，
+// 不回调 World，也不受之后 World::setBlockInternal 修改的影响，结果完全确定。
+// 只重建部分分段时，方块只拷贝这些分段及上下各一层，其余位置保持 Air（位图仍为整列）。
+// chunk 的 LOD 大于 0 时总是拷贝整个 chunk，按该 LOD 构建粗网格。
+// 四边相邻 chunk 的 LOD 大于 0 时不拷贝它的边框（保持空气），接缝处的边界面全部保留，不会因投票丢格而漏缝。
+// 立方 chunk 模式下上下两层边框取自上下（含对角）相邻的 chunk，它们的遮挡位另存在 paddedEdges_ 中；
+// 整列模式这两层总是空气。
+class MeshInput {
+public:
+    static constexpr int PADDED_SIZE = Chunk::SIZE + 2;
+    static constexpr int PADDED_HEIGHT = Chunk::HEIGHT + 2;
+
+    // sections 为要重建的分段
+    explicit MeshInput(const Chunk& chunk, Chunk::SectionMask sections = Chunk::ALL_SECTIONS);
+
+    ChunkCoord coord() const { return coord_; }
+    Chunk::SectionMask sections() const { return sections_; }
+    int lod() const { return lod_; }
+    glm::ivec3 worldOrigin() const { return glm::ivec3(coord_.x * Chunk::SIZE, coord_.y * Chunk::HEIGHT, coord_.z * Chunk::SIZE); }
+    // 拍快照时 chunk 的修改版本，用来判断结果上传时是否已经过期
+    std::uint64_t revision() const { return revision_; }
+
+    // 局部坐标，x/z 取 -1..SIZE、y 取 -1..HEIGHT（边框来自邻居，邻居未加载或越出世界高度时为 Air）
+    BlockId block(int x, int y, int z) const { return voxels_[paddedIndex(x, y, z)]; }
+    std::uint64_t columnBits(Chunk::Occupancy kind, int x, int z, int word) const {
+        return columnMasks_[static_cast<std::size_t>(kind)]
+                           [static_cast<std::size_t>(z * Chunk::SIZE + x) * Chunk::COLUMN_WORDS + static_cast<std::size_t>(word)];
+    }
+    // 方块 (x,y,z) 是否遮挡相邻面，范围同 block()；取自各 chunk 的 Opaque 占用位图，
+    // y 为 -1 或 HEIGHT 时取上下边框（整列模式为 false）
+    bool occludes(int x, int y, int z) const {
+        if (y < 0) {
+            return opaqueBelow(x, z);
+        }
+        if (y >= Chunk::HEIGHT) {
+            return opaqueAbove(x, z);
+        }
+        return ((opaqueColumn(x, z)[y / 64] >> (y % 64)) & 1u) != 0;
+    }
+    // 含一格边框的 Opaque 列位图（COLUMN_WORDS 个字），x/z 取 -1..SIZE
+    const std::uint64_t* opaqueColumn(int x, int z) const {
+        return &paddedOpaque_[static_cast<std::size_t>((z + 1) * PADDED_SIZE + (x + 1)) * Chunk::COLUMN_WORDS];
+    }
+    // 列 (x,z) 紧贴 chunk 底层之下 / 顶层之上的方块是否遮挡，x/z 取 -1..SIZE；只有立方模式可能为 true
+    bool opaqueBelow(int x, int z) const { return Chunk::CUBIC && (paddedEdges_[edgeIndex(x, z)] & kEdgeBelow) != 0; }
+    bool opaqueAbove(int x, int z) const { return Chunk::CUBIC && (paddedEdges_[edgeIndex(x, z)] & kEdgeAbove) != 0; }
+
+    // 快照占用的字节数：对象本身（含内联的列位图）加上方块、Opaque 位图与上下边框遮挡位几个堆数组
+    std::size_t memoryBytes() const {
+        return sizeof(*this) + voxels_.capacity() * sizeof(BlockId) + paddedOpaque_.capacity() * sizeof(std::uint64_t) +
+               paddedEdges_.capacity();
+    }
+
+    static std::size_t paddedIndex(int x, int y, int z) {
+        return (static_cast<std::size_t>(y + 1) * PADDED_SIZE + static_cast<std::size_t>(z + 1)) * PADDED_SIZE +
+               static_cast<std::size_t>(x + 1);
+    }
+
+private:
+    static constexpr std::uint8_t kEdgeBelow = 1;
+    static constexpr std::uint8_t kEdgeAbove = 2;
+
+    static std::size_t edgeIndex(int x, int z) { return static_cast<std::size_t>((z + 1) * PADDED_SIZE + (x + 1)); }
+    void copyColumns(const Chunk& source, int dstX0, int dstZ0, int srcX0, int srcZ0, int width, int depth);
+    // 立方模式：把上（dy > 0）/下相邻 chunk 的底层/顶层拷进 y = HEIGHT / -1 的边框
+    void copyEdgeLayer(const Chunk& source, int dy, int dstX0, int dstZ0, int srcX0, int srcZ0, int width, int depth);
+
+    ChunkCoord coord_{};
+    Chunk::SectionMask sections_ = Chunk::ALL_SECTIONS;
+    int lod_ = 0;
+    std::uint64_t revision_ = 0;
+    std::vector<BlockId> voxels_;
+    std::vector<std::uint64_t> paddedOpaque_;
+    std::vector<std::uint8_t> paddedEdges_; // 立方模式每个边框列的 kEdgeBelow / kEdgeAbove；整列模式为空
+    std::array<std::array<std::uint64_t, Chunk::SIZE * Chunk::SIZE * Chunk::COLUMN_WORDS>, 3> columnMasks_{};
+};
+
+// SectionMeshData: 一个 16³ 分段的顶点。每 4 个连续顶点构成一个四边形，不再生成索引：
+// 绘制时统一使用 QuadIndexBuffer。贪心合并不跨越分段边界，四边形按锚点所在分段归属
+// 不透明顶点按面方向（+X,-X,+Y,-Y,+Z,-Z）分成 6 段连续区间，绘制时可整段跳过背对相机的方向
+struct SectionMeshData {
+    std::vector<ChunkVertex> solidVertices; // chunk 局部坐标，绘制时由 uChunkOrigin 平移
+    std::array<std::uint32_t, 6> solidFaceQuads{}; // solidVertices 中各方向依次占用的四边形数
+    std::vector<ChunkVertex> alphaVertices;  // 玻璃等透明方块
+    std::vector<ChunkVertex> liquidVertices; // 水面与外露的侧面：同种液体之间的面已剔除，开销随表面积而非体积增长
+    std::vector<BillboardInstance> billboards; // 植物实例，按所在分段归属
+
+    bool empty() const {
+        return solidVertices.empty() && alphaVertices.empty() && liquidVertices.empty() && billboards.empty();
+    }
+};
+
+// ChunkMeshData: CPU 阶段的输出（各分段顶点与包围信息），由主线程交给 Chunk::applyMesh 上传
+struct ChunkMeshData {
+    Chunk::SectionMask sections = 0; // 本次构建的分段，其余 sectionMeshes 为空且不应上传
+    int lod = 0;
+    std::array<SectionMeshData, Chunk::SECTION_COUNT> sectionMeshes;
+    int minY = 0; // 整个 chunk 的非空气层 [minY, maxY)
+    int maxY = 0;
+    std::size_t scratchBytes = 0; // 构建所在线程的常驻临时缓冲总容量
+    std::size_t allocations = 0;  // 本次构建中不得不扩容的缓冲数（临时缓冲与输出数组），稳态应为 0
+
+    bool empty() const {
+        return std::all_of(sectionMeshes.begin(), sectionMeshes.end(), [](const SectionMeshData& section) { return section.empty(); });
+    }
+    // 各输出数组的容量（字节）；复用时这部分内存常驻
+    std::size_t capacityBytes() const {
+        std::size_t vertices = 0;
+        for (const SectionMeshData& section : sectionMeshes) {
+            vertices += section.solidVertices.capacity() + section.alphaVertices.capacity() +
+                        section.liquidVertices.capacity() + section.billboards.capacity();
+        }
+        return vertices * sizeof(ChunkVertex);
+    }
+};
+
+// 贪心合并的实现：Binary 用 64 位列掩码按位求出可见面、按行用 ctz 合并；
+// Reference 为逐体素填充 mask 再逐项比较的原始实现，只留作基准与结果对照
+enum class GreedyMesher { Binary, Reference };
+
+// 贪心网格构建（不调用任何 GL 接口，可在工作线程运行）。
+// registry 需可被多个线程同时只读访问；两种实现输出完全相同的顶点。
+// input.lod() > 0 时忽略 mesher，按 LOD 粗网格构建：每格由格内各列最顶上的方块投票决定种类，
+// 非空气体素过半才算实心；不生成植物与 AO，chunk 边界上的面只在邻居一侧确定被遮挡时才剔除，
+// 其余保留为裙边，盖住与不同 LOD 邻居之间的缝隙。
+// 中间结果写入每个线程一份的常驻临时缓冲，容量只增不减；结果写入 out，其数组先清空、保留容量，
+// 因此传入上传完毕的旧 ChunkMeshData 可复用其内存。同一线程构建过最大的 chunk 后不再分配堆内存。
+void buildChunkMesh(const MeshInput& input, const BlockRegistry& registry, ChunkMeshData& out,
+                    GreedyMesher mesher = GreedyMesher::Binary);
+// 便捷版本：每次分配新的输出数组
+ChunkMeshData buildChunkMesh(const MeshInput& input, const BlockRegistry& registry, GreedyMesher mesher = GreedyMesher::Binary);
@@ -0,0 +1,48 @@
+#include "chunk_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+ChunkPool::ChunkPool(std::size_t maxFree) {
+    setMaxFree(maxFree);
+}
+
+void ChunkPool::setMaxFree(std::size_t maxFree) {
+    maxFree_ = maxFree;
+    if (free_.size() > maxFree_) {
+        free_.resize(maxFree_);
+    }
+    // 一次性预留空闲列表容量，之后 release 不再扩容
+    free_.reserve(maxFree_);
+    stats_.free = free_.size();
+}
+
+std::unique_ptr<Chunk> ChunkPool::acquire(ChunkCoord coord, const BlockRegistry& registry) {
+    std::unique_ptr<Chunk> chunk;
+    if (!free_.empty()) {
+        chunk = std::move(free_.back());
+        free_.pop_back();
+        chunk->reset(coord);
+        ++stats_.hits;
+    } else {
+        chunk = std::make_unique<Chunk>(coord, registry);
+        ++stats_.misses;
+    }
+    ++stats_.live;
+    stats_.highWater = std::max(stats_.highWater, stats_.live);
+    stats_.free = free_.size();
+    return chunk;
+}
+
+void ChunkPool::release(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) {
+        return;
+    }
+    if (stats_.live > 0) {
+        --stats_.live;
+    }
+    if (free_.size() < maxFree_) {
+        free_.push_back(std::move(chunk));
+    }
+    stats_.free = free_.size();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "chunk.h"
+
+// ChunkPool: 回收卸载的 Chunk（连同其分段体素缓冲与 VAO/VBO 句柄），
+// 加载新 chunk 时优先复用，避免来回飞行时反复分配内存和创建 GL 对象。
+class ChunkPool {
+public:
+    struct Stats {
+        std::size_t hits = 0;      // acquire 命中空闲列表
+        std::size_t misses = 0;    // acquire 需要新建 Chunk
+        std::size_t live = 0;      // 当前借出（已加载）的 chunk 数
+        std::size_t highWater = 0; // live 的历史最大值
+        std::size_t free = 0;      // 空闲列表中的 chunk 数
+    };
+
+    explicit ChunkPool(std::size_t maxFree = 0);
+
+    // 上限之外归还的 chunk 会被直接释放
+    void setMaxFree(std::size_t maxFree);
+
+    std::unique_ptr<Chunk> acquire(ChunkCoord coord, const BlockRegistry& registry);
+    void release(std::unique_ptr<Chunk> chunk);
+
+    const Stats& stats() const { return stats_; }
+
+    // 遍历空闲列表中的 chunk（内存统计用）
+    template <typename Fn>
+    void forEachFree(Fn&& fn) const {
+        for (const auto& chunk : free_) {
+            fn(*chunk);
+        }
+    }
+
+private:
+    std::size_t maxFree_ = 0;
+    std::vector<std::unique_ptr<Chunk>> free_;
+    Stats stats_{};
+};
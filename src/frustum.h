@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+// Frustum: 由 viewProj 矩阵提取的 6 个裁剪平面（Gribb–Hartmann），用于 chunk 包围盒剔除。
+// 平面法线朝内，未归一化——只比较符号，不需要真实距离。
+class Frustum {
+public:
+    explicit Frustum(const glm::mat4& viewProj) {
+        // glm 为列主序：第 i 行为 (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&](int i) {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+        planes_[0] = row(3) + row(0); // left
+        planes_[1] = row(3) - row(0); // right
+        planes_[2] = row(3) + row(1); // bottom
+        planes_[3] = row(3) - row(1); // top
+        planes_[4] = row(3) + row(2); // near
+        planes_[5] = row(3) - row(2); // far
+    }
+
+    // 轴对齐包围盒 [min, max] 是否与视锥相交（保守判断：可能把少量视锥外的盒子判为可见）
+    bool intersects(const glm::vec3& min, const glm::vec3& max) const {
+        for (const glm::vec4& plane : planes_) {
+            // 取沿平面法线方向最远的顶点，它都在平面外侧则整个盒子不可见
+            glm::vec3 p(plane.x >= 0.0f ? max.x : min.x,
+                        plane.y >= 0.0f ? max.y : min.y,
+                        plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), p) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::array<glm::vec4, 6> planes_{};
+};
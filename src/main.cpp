@@ -195,6 +195,8 @@ struct PlayerState {
 };
 
 constexpr int kShadowMapSize = 2048;
+constexpr std::size_t kShadowMapBytes = static_cast<std::size_t>(kShadowMapSize) * kShadowMapSize * 4; // DEPTH32F
+constexpr double kMemoryLogInterval = 10.0; // 内存统计日志的输出间隔（秒）
 constexpr float kPlayerRadius = 0.3f;
 constexpr float kPlayerHeight = 1.8f;
 constexpr float kEyeHeight = 1.62f;
@@ -305,8 +307,8 @@ static World::AnimalUVLayout buildSheepUV(int texW, int texH) {
     return layout;
 }
 
-glm::mat4 buildLightSpaceMatrix(const glm::vec3& center, const glm::vec3& sunDir, int renderDistance) {
-    float range = static_cast<float>(renderDistance * Chunk::SIZE);
+// range: 阴影覆盖的水平半径（方块）；只需覆盖全精度网格的范围，远处 LOD chunk 不投/不收阴影细节
+glm::mat4 buildLightSpaceMatrix(const glm::vec3& center, const glm::vec3& sunDir, float range) {
     range = glm::max(range, 64.0f);
     float distance = range * 1.5f;
     glm::vec3 lightDir = glm::normalize(-sunDir);
@@ -325,47 +327,24 @@ int floorToInt(float value) {
     return static_cast<int>(std::floor(value));
 }
 
-bool isSolidBlock(const World& world, const BlockRegistry& registry, int x, int y, int z) {
-    BlockId id = world.blockAt(glm::ivec3(x, y, z));
-    if (id == BlockId::Air) {
-        return false;
-    }
-    return registry.info(id).solid;
-}
-
-bool anySolidInRange(const World& world,
-                     const BlockRegistry& registry,
-                     int x0,
-                     int x1,
-                     int y0,
-                     int y1,
-                     int z0,
-                     int z1) {
+// 碰撞只关心实心方块：直接查询 chunk 维护的占用位图，不再逐格查方块表
+bool anySolidInRange(const World& world, int x0, int x1, int y0, int y1, int z0, int z1) {
     if (x0 > x1 || y0 > y1 || z0 > z1) {
         return false;
     }
-    for (int y = y0; y <= y1; ++y) {
-        for (int z = z0; z <= z1; ++z) {
-            for (int x = x0; x <= x1; ++x) {
-                if (isSolidBlock(world, registry, x, y, z)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    return !world.isRangeEmpty(glm::ivec3(x0, y0, z0), glm::ivec3(x1, y1, z1), Chunk::Occupancy::Solid);
 }
 
-bool isGrounded(const World& world, const BlockRegistry& registry, const glm::vec3& pos) {
+bool isGrounded(const World& world, const glm::vec3& pos) {
     int x0 = floorToInt(pos.x - kPlayerRadius + kCollisionEps);
     int x1 = floorToInt(pos.x + kPlayerRadius - kCollisionEps);
     int z0 = floorToInt(pos.z - kPlayerRadius + kCollisionEps);
     int z1 = floorToInt(pos.z + kPlayerRadius - kCollisionEps);
     int yCheck = floorToInt(pos.y - 0.02f);
-    return anySolidInRange(world, registry, x0, x1, yCheck, yCheck, z0, z1);
+    return anySolidInRange(world, x0, x1, yCheck, yCheck, z0, z1);
 }
 
-void resolvePlayerCollisions(const World& world, const BlockRegistry& registry, PlayerState& player, float dt) {
+void resolvePlayerCollisions(const World& world, PlayerState& player, float dt) {
     glm::vec3 pos = player.position;
     glm::vec3 vel = player.velocity;
 
@@ -377,7 +356,7 @@ void resolvePlayerCollisions(const World& world, const BlockRegistry& registry,
         int y1 = floorToInt(p.y + kPlayerHeight - kCollisionEps);
         int z0 = floorToInt(p.z - kPlayerRadius + kCollisionEps);
         int z1 = floorToInt(p.z + kPlayerRadius - kCollisionEps);
-        return anySolidInRange(world, registry, x0, x1, y0, y1, z0, z1);
+        return anySolidInRange(world, x0, x1, y0, y1, z0, z1);
     };
 
     // X axis
@@ -452,7 +431,7 @@ void resolvePlayerCollisions(const World& world, const BlockRegistry& registry,
          int z0 = floorToInt(pos.z - kPlayerRadius + kCollisionEps);
          int z1 = floorToInt(pos.z + kPlayerRadius - kCollisionEps);
          int yBelow = floorToInt(pos.y - 0.05f);
-         if(anySolidInRange(world, registry, x0, x1, yBelow, yBelow, z0, z1)) {
+         if(anySolidInRange(world, x0, x1, yBelow, yBelow, z0, z1)) {
              // If we are VERY close to ground, snap? No, just flag.
              if(pos.y - (yBelow + 1) < 0.05f) {
                  player.onGround = true;
@@ -543,13 +522,34 @@ int main() {
     registry.build(atlas);
 
     Shader blockShader((paths.shaderDir / "block.vert").string(), (paths.shaderDir / "block.frag").string());
-    blockShader.use();
-    blockShader.setInt("uAtlas", 0);
+    // chunk 使用压缩顶点，顶点着色器不同，片元着色器与 blockShader 共用
+    Shader chunkShader((paths.shaderDir / "chunk.vert").string(), (paths.shaderDir / "block.frag").string());
+    // 植物十字面片按实例绘制，同样共用 block.frag
+    Shader billboardShader((paths.shaderDir / "billboard.vert").string(), (paths.shaderDir / "block.frag").string());
     glm::vec2 atlasSize = glm::vec2(static_cast<float>(atlas.atlasWidth()), static_cast<float>(atlas.atlasHeight()));
     glm::vec2 atlasInvSize = glm::vec2(1.0f / atlasSize.x, 1.0f / atlasSize.y);
-    blockShader.setVec2("uAtlasSize", atlasSize);
-    blockShader.setVec2("uAtlasInvSize", atlasInvSize);
-    blockShader.setFloat("uAtlasTileSize", static_cast<float>(atlas.tileSize()));
+    for (const Shader* shader : {&blockShader, &chunkShader, &billboardShader}) {
+        shader->use();
+        shader->setInt("uAtlas", 0);
+        shader->setVec2("uAtlasSize", atlasSize);
+        shader->setVec2("uAtlasInvSize", atlasInvSize);
+        shader->setFloat("uAtlasTileSize", static_cast<float>(atlas.tileSize()));
+        shader->setInt("uPigTex", 1);
+        shader->setInt("uCowTex", 2);
+        shader->setInt("uSheepTex", 3);
+        shader->setInt("uShadowMap", 4);
+        shader->setInt("uBiomeTint", 5);
+        shader->setFloat("uBiomeTintInvSize", 1.0f / static_cast<float>(BiomeTintMap::kSize * BiomeTintMap::kBlocksPerTexel));
+        shader->setMat4("uLightSpace", glm::mat4(1.0f));
+    }
+    const std::vector<BlockAnimation>& animations = registry.animations();
+    for (const Shader* shader : {&chunkShader, &billboardShader}) {
+        shader->use();
+        for (std::size_t i = 0; i < animations.size(); ++i) {
+            shader->setVec2("uAnimations[" + std::to_string(i) + "]",
+                            glm::vec2(static_cast<float>(animations[i].frames), animations[i].speed));
+        }
+    }
 
     // 加载 Faithful 资源包中的猪/牛/羊贴图
     std::filesystem::path entityDir = paths.root / "Faithful 64x - September 2025 Release/assets/minecraft/textures/entity";
@@ -566,15 +566,10 @@ int main() {
     World::AnimalUVLayout cowUV = buildCowUV(cowW, cowH);
     World::AnimalUVLayout sheepUV = buildSheepUV(sheepW, sheepH);
 
-    blockShader.setInt("uPigTex", 1);
-    blockShader.setInt("uCowTex", 2);
-    blockShader.setInt("uSheepTex", 3);
-    blockShader.setInt("uShadowMap", 4);
-    blockShader.setMat4("uLightSpace", glm::mat4(1.0f));
-
     Shader shadowShader((paths.shaderDir / "shadow.vert").string(), (paths.shaderDir / "shadow.frag").string());
     shadowShader.use();
     shadowShader.setMat4("uModel", glm::mat4(1.0f));
+    Shader chunkShadowShader((paths.shaderDir / "chunk_shadow.vert").string(), (paths.shaderDir / "shadow.frag").string());
 
     GLuint shadowFbo = 0;
     GLuint shadowMap = 0;
@@ -608,6 +603,7 @@ int main() {
     GameState gameState = GameState::Menu;
     
     char seedInput[64] = "";
+    int renderDistance = World::kDefaultRenderDistance;
     char saveNameInput[64] = "World1";
     int selectedSaveIdx = -1;
     std::filesystem::path saveDir = paths.root / "saves";
@@ -619,7 +615,7 @@ int main() {
 
     // Helper to start game
     auto startGame = [&](int seed, const glm::vec3& startPos) {
-        world = std::make_unique<World>(atlas, registry, pigUV, cowUV, sheepUV, seed);
+        world = std::make_unique<World>(atlas, registry, pigUV, cowUV, sheepUV, seed, renderDistance);
         camera = std::make_unique<Camera>(startPos);
         camera->setPerspective(60.0f, static_cast<float>(initialWidth) / initialHeight, 0.1f, 1000.0f);
         player.position = startPos - glm::vec3(0.0f, kEyeHeight, 0.0f);
@@ -661,6 +657,7 @@ int main() {
     int selectedSlot = 0;
 
     MiningState mining;
+    double lastMemoryLog = lastTime;
     bool previousRight = false;
     bool tabPressedLast = false;
     bool capturePressedLast = false;
@@ -711,6 +708,8 @@ int main() {
             ImGui::Separator();
             ImGui::InputText("World Name", saveNameInput, 64);
             ImGui::InputText("Seed (Optional)", seedInput, 64);
+            // 超出细节半径的 chunk 使用 LOD 网格，远视距的三角形数接近默认视距
+            ImGui::SliderInt("Render Distance", &renderDistance, 4, World::kMaxRenderDistance);
             
             if (ImGui::Button("Create Random World", ImVec2(-1, 40))) {
                 int seed = rand();
@@ -909,7 +908,7 @@ int main() {
                 if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) vertical -= 1.0f;
                 player.velocity.y = vertical * speed;
 
-                resolvePlayerCollisions(*world, registry, player, dt);
+                resolvePlayerCollisions(*world, player, dt);
                 if (!player.onGround) {
                     flyHasLifted = true;
                 } else if (flyHasLifted) {
@@ -932,7 +931,7 @@ int main() {
                     player.velocity.y = jumpSpeed;
                 }
 
-                resolvePlayerCollisions(*world, registry, player, dt);
+                resolvePlayerCollisions(*world, player, dt);
             }
             camera->setPosition(player.position + glm::vec3(0.0f, kEyeHeight, 0.0f));
         } else {
@@ -984,16 +983,18 @@ int main() {
 
         world->update(camera->position(), dt);
 
-        glm::mat4 lightSpace = buildLightSpaceMatrix(camera->position(), world->sunDirection(), world->renderDistance());
+        glm::mat4 lightSpace = buildLightSpaceMatrix(camera->position(), world->sunDirection(), world->detailDistance());
         shadowShader.use();
         shadowShader.setMat4("uLightSpace", lightSpace);
         shadowShader.setMat4("uModel", glm::mat4(1.0f));
+        chunkShadowShader.use();
+        chunkShadowShader.setMat4("uLightSpace", lightSpace);
 
         glViewport(0, 0, kShadowMapSize, kShadowMapSize);
         glBindFramebuffer(GL_FRAMEBUFFER, shadowFbo);
         glClear(GL_DEPTH_BUFFER_BIT);
         glCullFace(GL_FRONT);
-        world->render(shadowShader);
+        world->renderShadows(chunkShadowShader, shadowShader, lightSpace);
         glCullFace(GL_BACK);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, fbw, fbh);
@@ -1030,29 +1031,32 @@ int main() {
         glClearColor(sky.r, sky.g, sky.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        blockShader.use();
-        blockShader.setMat4("uModel", glm::mat4(1.0f)); // Ensure default model matrix
         glm::mat4 view = camera->viewMatrix();
         glm::mat4 proj = camera->projectionMatrix();
-        blockShader.setMat4("uViewProj", proj * view);
-        blockShader.setVec3("uSunDir", world->sunDirection());
-        blockShader.setVec3("uSunColor", world->sunColor() * sunIntensity);
-        blockShader.setVec3("uAmbient", world->ambientColor() * ambientIntensity);
-        blockShader.setVec3("uEyePos", camera->position());
-        blockShader.setMat4("uLightSpace", lightSpace);
-        blockShader.setFloat("uFogDensity", world->fogDensity() * fogScale);
-        blockShader.setVec2("uAtlasSize", glm::vec2(atlas.atlasWidth(), atlas.atlasHeight()));
-        blockShader.setVec2("uAtlasInvSize", glm::vec2(1.0f / atlas.atlasWidth(), 1.0f / atlas.atlasHeight()));
-        blockShader.setFloat("uAtlasTileSize", static_cast<float>(atlas.tileSize()));
-        blockShader.setVec3("uTargetBlock", hit.hit ? glm::vec3(hit.block) : glm::vec3(0.0f));
-        blockShader.setFloat("uTargetActive", hit.hit ? 1.0f : 0.0f);
-        blockShader.setFloat("uBreakProgress", mining.active ? glm::clamp(mining.progress, 0.0f, 1.0f) : 0.0f);
-        blockShader.setFloat("uTime", static_cast<float>(now));
-        blockShader.setVec2("uCloudOffset", world->cloudOffset());
-        blockShader.setFloat("uCloudTime", world->cloudTime());
-        blockShader.setFloat("uCloudEnabled", showClouds ? 1.0f : 0.0f);
-        blockShader.setFloat("uShadowStrength", shadowStrength);
-        blockShader.setFloat("uAoStrength", aoStrength);
+        // blockShader、chunkShader 与 billboardShader 共用片元着色器，逐帧 uniform 都要设置
+        for (const Shader* shader : {&chunkShader, &billboardShader, &blockShader}) {
+            shader->use();
+            shader->setMat4("uModel", glm::mat4(1.0f)); // Ensure default model matrix
+            shader->setMat4("uViewProj", proj * view);
+            shader->setVec3("uSunDir", world->sunDirection());
+            shader->setVec3("uSunColor", world->sunColor() * sunIntensity);
+            shader->setVec3("uAmbient", world->ambientColor() * ambientIntensity);
+            shader->setVec3("uEyePos", camera->position());
+            shader->setMat4("uLightSpace", lightSpace);
+            shader->setFloat("uFogDensity", world->fogDensity() * fogScale);
+            shader->setVec2("uAtlasSize", glm::vec2(atlas.atlasWidth(), atlas.atlasHeight()));
+            shader->setVec2("uAtlasInvSize", glm::vec2(1.0f / atlas.atlasWidth(), 1.0f / atlas.atlasHeight()));
+            shader->setFloat("uAtlasTileSize", static_cast<float>(atlas.tileSize()));
+            shader->setVec3("uTargetBlock", hit.hit ? glm::vec3(hit.block) : glm::vec3(0.0f));
+            shader->setFloat("uTargetActive", hit.hit ? 1.0f : 0.0f);
+            shader->setFloat("uBreakProgress", mining.active ? glm::clamp(mining.progress, 0.0f, 1.0f) : 0.0f);
+            shader->setFloat("uTime", static_cast<float>(now));
+            shader->setVec2("uCloudOffset", world->cloudOffset());
+            shader->setFloat("uCloudTime", world->cloudTime());
+            shader->setFloat("uCloudEnabled", showClouds ? 1.0f : 0.0f);
+            shader->setFloat("uShadowStrength", shadowStrength);
+            shader->setFloat("uAoStrength", aoStrength);
+        }
 
         // Draw Sun first (behind everything, but we use depth test so it's fine if it's far)
         // Actually, to be safe, disable depth write for sun or just draw it far away.
@@ -1069,15 +1073,26 @@ int main() {
         glBindTexture(GL_TEXTURE_2D, sheepTex);
         glActiveTexture(GL_TEXTURE4);
         glBindTexture(GL_TEXTURE_2D, shadowMap);
+        world->biomeTints().bind(5);
 
         glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
-        world->render(blockShader);
+        Frustum viewFrustum(proj * view);
+        world->render(chunkShader, blockShader, &viewFrustum, &camera->position());
+        // 十字面片两面可见，关闭背面剔除；镂空像素在片元着色器中丢弃，可以照常写深度
+        glDisable(GL_CULL_FACE);
+        world->renderBillboards(billboardShader, &viewFrustum);
+        glEnable(GL_CULL_FACE);
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDepthMask(GL_FALSE);
-        world->renderTransparent(blockShader);
+        // 同种液体之间的面已被剔除，只剩水面与外露侧面：关闭背面剔除，水下抬头也能看到水面
+        glDisable(GL_CULL_FACE);
+        world->renderLiquids(chunkShader, &viewFrustum);
+        glEnable(GL_CULL_FACE);
+        world->renderTransparent(chunkShader, &viewFrustum);
+        blockShader.use();
         if (showClouds) {
             world->renderClouds(blockShader, true);
         }
@@ -1112,7 +1127,7 @@ int main() {
                                  // Note: Simple world regeneration. 
                                  // In a real engine, might need to clear resources or loading screen.
                                  // But here we rely on RAII of unique_ptr and World class.
-                                 world = std::make_unique<World>(atlas, registry, pigUV, cowUV, sheepUV, seed);
+                                 world = std::make_unique<World>(atlas, registry, pigUV, cowUV, sheepUV, seed, renderDistance);
                              }
                              player.position = glm::vec3(x, y, z);
                              camera->setPosition(player.position + glm::vec3(0.0f, kEyeHeight, 0.0f));
@@ -1150,6 +1165,14 @@ int main() {
             drawList->AddLine(ImVec2(center.x - half, center.y), ImVec2(center.x + half, center.y), color, thickness);
             drawList->AddLine(ImVec2(center.x, center.y - half), ImVec2(center.x, center.y + half), color, thickness);
         }
+        MemoryStats memory = world->memoryStats();
+        memory.atlasGpuBytes = atlas.gpuBytes();
+        memory.shadowMapGpuBytes = kShadowMapBytes;
+        if (now - lastMemoryLog >= kMemoryLogInterval) {
+            std::cout << "[memory] " << memory.summary() << std::endl;
+            lastMemoryLog = now;
+        }
+
         ImGui::Begin("mycraft HUD");
         ImGui::Text("FPS: %.1f", 1.0f / std::max(dt, 0.0001f));
         ImGui::Text("Pos: %.1f %.1f %.1f", camera->position().x, camera->position().y, camera->position().z);
@@ -1162,7 +1185,37 @@ int main() {
             ImGui::EndPopup();
         }
 
-        ImGui::Text("Chunks: %d", world->chunkCount());
+        ImGui::Text("Chunks: %d (drawn %d)", world->chunkCount(), world->drawnChunkCount());
+        ImGui::Text("Solid quads: %zu of %zu (back faces skipped)", world->drawnSolidQuadCount(), world->visibleSolidQuadCount());
+        const auto lodCounts = world->lodChunkCounts();
+        ImGui::Text("LOD chunks: %d / %d / %d / %d", lodCounts[0], lodCounts[1], lodCounts[2], lodCounts[3]);
+        ImGui::Text("Billboards drawn: %zu", world->drawnBillboardCount());
+        const MeshScheduler::Stats meshQueue = world->meshQueueStats();
+        ImGui::Text("Mesh Queue: %zu chunks (%zu edits), oldest %.0f ms, building %zu",
+                    meshQueue.queued, meshQueue.edits, meshQueue.oldestAgeMs, world->meshJobsInFlight());
+        const World::MeshBuildStats& meshBuilds = world->meshBuildStats();
+        ImGui::Text("Mesh builds: %zu, buffer allocations %zu (last build %zu)",
+                    meshBuilds.builds, meshBuilds.allocations, meshBuilds.lastAllocations);
+        const ChunkPool::Stats& poolStats = world->chunkPoolStats();
+        ImGui::Text("Chunk Pool: hits %zu / misses %zu, free %zu, peak %zu",
+                    poolStats.hits, poolStats.misses, poolStats.free, poolStats.highWater);
+        const ChunkCache::Stats& cacheStats = world->chunkCacheStats();
+        ImGui::Text("Chunk Cache: %zu chunks, %.1f / %.1f MB, hits %zu / misses %zu, evicted %zu",
+                    cacheStats.entries,
+                    static_cast<double>(cacheStats.bytes) / (1024.0 * 1024.0),
+                    static_cast<double>(cacheStats.budget) / (1024.0 * 1024.0),
+                    cacheStats.hits, cacheStats.misses, cacheStats.evictions);
+        auto mib = [](std::size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+        ImGui::Text("Memory CPU: %.1f MB (voxels %.1f, meta %.1f, scratch %.2f, pool %.1f, cache %.1f)",
+                    mib(memory.cpuTotal()), mib(memory.voxelBytes), mib(memory.chunkMetaBytes),
+                    mib(memory.meshScratchBytes), mib(memory.poolBytes), mib(memory.cacheBytes));
+        ImGui::Text("Memory CPU: animals %zu (%.1f KB), mesh queue %.1f KB",
+                    world->animalCount(), static_cast<double>(memory.animalBytes) / 1024.0,
+                    static_cast<double>(memory.meshQueueBytes) / 1024.0);
+        ImGui::Text("Memory GPU: %.1f MB (meshes %.1f, pool %.1f, indices %.2f, tint %.1f, atlas %.1f, shadow %.1f)",
+                    mib(memory.gpuTotal()), mib(memory.meshGpuBytes), mib(memory.poolGpuBytes),
+                    mib(memory.quadIndexGpuBytes), mib(memory.biomeTintGpuBytes), mib(memory.atlasGpuBytes),
+                    mib(memory.shadowMapGpuBytes));
         ImGui::Checkbox("Wireframe", &wireframe);
         ImGui::Checkbox("Show Chunk Bounds", &showChunkBounds);
         ImGui::Checkbox("Show Clouds", &showClouds);
@@ -1175,6 +1228,11 @@ int main() {
         ImGui::SliderFloat("Shadow Strength", &shadowStrength, 0.0f, 1.5f, "%.2f");
         ImGui::SliderFloat("Day Speed", &daySpeed_val, 0.0f, 0.02f, "%.4f");
         world->setDaySpeed(daySpeed_val);
+        float billboardDistance = world->billboardDistance();
+        if (ImGui::SliderFloat("Plant Distance", &billboardDistance, 16.0f,
+                               world->detailDistance(), "%.0f")) {
+            world->setBillboardDistance(billboardDistance);
+        }
         ImGui::Separator();
         ImGui::Text("Physics");
         ImGui::Checkbox("Enable Physics", &enablePhysics);
@@ -0,0 +1,33 @@
+#include "memory_stats.h"
+
+#include <cstdio>
+
+namespace {
+double toMiB(std::size_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+} // namespace
+
+std::string MemoryStats::summary() const {
+    char buffer[512];
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "cpu %.1f MiB (voxels %.1f, meta %.1f, scratch %.1f, pool %.1f, cache %.1f, animals %.2f, queue %.2f) "
+                  "gpu %.1f MiB (meshes %.1f, pool %.1f, indices %.2f, tint %.1f, atlas %.1f, shadow %.1f)",
+                  toMiB(cpuTotal()),
+                  toMiB(voxelBytes),
+                  toMiB(chunkMetaBytes),
+                  toMiB(meshScratchBytes),
+                  toMiB(poolBytes),
+                  toMiB(cacheBytes),
+                  toMiB(animalBytes),
+                  toMiB(meshQueueBytes),
+                  toMiB(gpuTotal()),
+                  toMiB(meshGpuBytes),
+                  toMiB(poolGpuBytes),
+                  toMiB(quadIndexGpuBytes),
+                  toMiB(biomeTintGpuBytes),
+                  toMiB(atlasGpuBytes),
+                  toMiB(shadowMapGpuBytes));
+    return buffer;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// MemoryStats: 按子系统统计的内存占用（字节）。
+// CPU 部分按容器容量计，GPU 部分按实际上传给 glBufferData / glTexImage 的字节数计，
+// 不含驱动内部的对齐与额外开销。
+struct MemoryStats {
+    // CPU
+    std::size_t voxelBytes = 0;       // 已加载 chunk 的方块分段（调色板 + 位压缩数据）
+    std::size_t chunkMetaBytes = 0;   // 已加载 chunk 的占用位图、高度图、邻居链接等固定开销
+    std::size_t meshScratchBytes = 0; // 构建 mesh 的常驻缓冲：各工作线程的临时缓冲 + 待复用的输出数组
+    std::size_t poolBytes = 0;        // ChunkPool 空闲列表中 chunk 的 CPU 占用
+    std::size_t cacheBytes = 0;       // ChunkCache 中的压缩数据
+    std::size_t animalBytes = 0;      // World::animals_
+    std::size_t meshQueueBytes = 0;   // 待重建 mesh 的队列与在途构建任务的快照
+
+    // GPU
+    std::size_t meshGpuBytes = 0;     // 已加载 chunk 的 VBO
+    std::size_t poolGpuBytes = 0;     // 空闲 chunk 仍保留的 VBO
+    std::size_t quadIndexGpuBytes = 0; // 所有 chunk 共用的四边形索引缓冲
+    std::size_t biomeTintGpuBytes = 0; // 生物群系颜色纹理（BiomeTintMap）
+    std::size_t atlasGpuBytes = 0;    // 方块纹理数组（含 mipmap）
+    std::size_t shadowMapGpuBytes = 0;
+
+    std::size_t cpuTotal() const {
+        return voxelBytes + chunkMetaBytes + meshScratchBytes + poolBytes + cacheBytes + animalBytes + meshQueueBytes;
+    }
+    std::size_t gpuTotal() const {
+        return meshGpuBytes + poolGpuBytes + quadIndexGpuBytes + biomeTintGpuBytes + atlasGpuBytes + shadowMapGpuBytes;
+    }
+
+    // 单行摘要，供周期性日志输出
+    std::string summary() const;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <glm/glm.hpp>
 
 struct RenderVertex {
@@ -21,3 +24,29 @@ inline constexpr int kColorLocation = 3;
 inline constexpr int kLightLocation = 4;
 inline constexpr int kMaterialLocation = 5;
 inline constexpr int kAnimLocation = 6;
+
+// ChunkVertex: chunk mesh 专用的压缩顶点（12 字节，RenderVertex 为 64 字节），由 shaders/chunk.vert 解码。
+// 法线、光照、材质、动画等在同一个面的 4 个顶点上完全相同，只存索引与小整数：
+//   position: x[0,9) y[9,22) z[22,31)，chunk 局部坐标，单位 1/kChunkPositionScale 格；
+//             biome[31] 为 1 时片元颜色还要乘以 BiomeTintMap 中该处的生物群系颜色
+//   surface:  u[0,5) v[5,15) 贪心合并后的整格 UV；face[15,18) 面索引（kChunkBillboardFace 为十字面片）；
+//             ao[18,20) 遮挡该角的邻居数 0..3；animation[20,24) 动画槽（0 为无动画）；
+//             material[24,28) 单位 1/8；emission[28,32) 单位 1/15
+//   color:    顶点着色 RGB8 [0,24)（不含生物群系部分）；纹理数组层 [24,32)
+struct ChunkVertex {
+    std::uint32_t position;
+    std::uint32_t surface;
+    std::uint32_t color;
+};
+static_assert(sizeof(ChunkVertex) == 12, "ChunkVertex must stay tightly packed");
+
+inline constexpr int kChunkPositionScale = 16;
+inline constexpr int kChunkBillboardFace = 6;
+inline constexpr int kChunkMaxTextureLayers = 256;
+inline constexpr int kChunkPackedLocation = 0;
+
+// 植物十字面片改为实例化绘制：每株植物一个实例，沿用 ChunkVertex 的位布局（12 字节），
+// position 为底面中心，surface 的 uv/ao 不使用、face 恒为 kChunkBillboardFace，color 为着色与纹理层。
+// 两个交叉的四边形由 shaders/billboard.vert 按 gl_VertexID 生成，索引来自共用的 QuadIndexBuffer
+using BillboardInstance = ChunkVertex;
+inline constexpr int kBillboardQuads = 2;
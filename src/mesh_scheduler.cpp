@@ -0,0 +1,67 @@
+#include "mesh_scheduler.h"
+
+#include <algorithm>
+#include <tuple>
+
+void MeshScheduler::push(ChunkCoord coord, Priority priority) {
+    auto inserted = entries_.try_emplace(coord, Entry{priority, Clock::now()});
+    if (!inserted.second) {
+        // 已在队列中：只提升优先级，保留原来的入队时间
+        Entry& entry = inserted.first->second;
+        entry.priority = std::max(entry.priority, priority);
+    }
+}
+
+MeshScheduler::Priority MeshScheduler::priority(ChunkCoord coord) const {
+    auto it = entries_.find(coord);
+    return it == entries_.end() ? Priority::Normal : it->second.priority;
+}
+
+std::vector<ChunkCoord> MeshScheduler::ordered(ChunkCoord center, const Frustum* frustum) const {
+    // 排序键：(非编辑, 到相机 chunk 的平方距离, 不在视锥内)，越小越先派发；
+    // 距离相同的一圈 chunk 里先构建看得见的
+    using Key = std::tuple<int, int, int>;
+    std::vector<std::pair<Key, ChunkCoord>> keyed;
+    keyed.reserve(entries_.size());
+    for (const auto& item : entries_) {
+        const ChunkCoord coord = item.first;
+        const int dx = coord.x - center.x;
+        const int dy = coord.y - center.y; // 整列模式恒为 0
+        const int dz = coord.z - center.z;
+        bool visible = true;
+        if (frustum) {
+            const glm::vec3 min(static_cast<float>(coord.x * Chunk::SIZE), static_cast<float>(coord.y * Chunk::HEIGHT),
+                                static_cast<float>(coord.z * Chunk::SIZE));
+            const glm::vec3 max = min + glm::vec3(static_cast<float>(Chunk::SIZE), static_cast<float>(Chunk::HEIGHT), static_cast<float>(Chunk::SIZE));
+            visible = frustum->intersects(min, max);
+        }
+        keyed.emplace_back(Key{item.second.priority == Priority::Edit ? 0 : 1, dx * dx + dy * dy + dz * dz, visible ? 0 : 1}, coord);
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<ChunkCoord> order;
+    order.reserve(keyed.size());
+    for (const auto& item : keyed) {
+        order.push_back(item.second);
+    }
+    return order;
+}
+
+MeshScheduler::Stats MeshScheduler::stats() const {
+    Stats stats;
+    stats.queued = entries_.size();
+    const Clock::time_point now = Clock::now();
+    for (const auto& item : entries_) {
+        if (item.second.priority == Priority::Edit) {
+            ++stats.edits;
+        }
+        stats.oldestAgeMs = std::max(stats.oldestAgeMs, std::chrono::duration<double, std::milli>(now - item.second.since).count());
+    }
+    return stats;
+}
+
+std::size_t MeshScheduler::memoryBytes() const {
+    // 每个节点：键值对 + next 指针 + 缓存的哈希值
+    constexpr std::size_t kNodeBytes = sizeof(std::pair<const ChunkCoord, Entry>) + 2 * sizeof(void*);
+    return entries_.size() * kNodeBytes + entries_.bucket_count() * sizeof(void*);
+}
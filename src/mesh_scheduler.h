@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk.h"
+#include "frustum.h"
+
+// MeshScheduler: 等待重建 mesh 的 chunk 集合（仅主线程使用）。
+// 以 chunk 坐标为键去重：同一 chunk 被多次请求只保留一项，优先级取较高者、入队时间取最早的。
+// 派发顺序：玩家编辑 > 离相机近 > 在视锥内。
+class MeshScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Priority {
+        Normal = 0, // 加载、构建期间被修改后重排
+        Edit = 1,   // 玩家放置/破坏方块，尽快反映到画面上
+    };
+
+    struct Stats {
+        std::size_t queued = 0;   // 队列中的 chunk 数
+        std::size_t edits = 0;    // 其中由编辑触发的
+        double oldestAgeMs = 0.0; // 最早入队的一项已等待的时间
+    };
+
+    void push(ChunkCoord coord, Priority priority);
+    void erase(ChunkCoord coord) { entries_.erase(coord); }
+    bool contains(ChunkCoord coord) const { return entries_.count(coord) != 0; }
+    Priority priority(ChunkCoord coord) const;
+
+    // 按派发顺序排好的队列快照；center 为相机所在 chunk，frustum 为空时不考虑视锥
+    std::vector<ChunkCoord> ordered(ChunkCoord center, const Frustum* frustum) const;
+
+    std::size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    Stats stats() const;
+    // 哈希表节点与桶数组的近似占用
+    std::size_t memoryBytes() const;
+
+private:
+    struct Entry {
+        Priority priority = Priority::Normal;
+        Clock::time_point since{};
+    };
+
+    std::unordered_map<ChunkCoord, Entry, ChunkCoordHash> entries_;
+};
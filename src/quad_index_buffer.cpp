@@ -0,0 +1,57 @@
+#include "quad_index_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+QuadIndexBuffer::~QuadIndexBuffer() {
+    for (Buffer* buffer : {&short_, &int_}) {
+        if (buffer->ebo) {
+            glDeleteBuffers(1, &buffer->ebo);
+        }
+    }
+}
+
+GLenum QuadIndexBuffer::bind(std::size_t quadCount) {
+    if (quadCount <= kMaxShortQuads) {
+        // 16 位缓冲一次建满，之后只绑定
+        grow<std::uint16_t>(short_, kMaxShortQuads);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, short_.ebo);
+        return GL_UNSIGNED_SHORT;
+    }
+    grow<std::uint32_t>(int_, quadCount);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, int_.ebo);
+    return GL_UNSIGNED_INT;
+}
+
+std::size_t QuadIndexBuffer::gpuBytes() const {
+    return short_.quads * 6 * sizeof(std::uint16_t) + int_.quads * 6 * sizeof(std::uint32_t);
+}
+
+template <typename Index>
+void QuadIndexBuffer::grow(Buffer& buffer, std::size_t quadCount) {
+    if (buffer.ebo && buffer.quads >= quadCount) {
+        return;
+    }
+    // 按倍数增长，避免顶点数略有增加就重新上传
+    const std::size_t quads = std::max(quadCount, buffer.quads * 2);
+    static constexpr Index kPattern[6] = {0, 1, 2, 2, 3, 0};
+    std::vector<Index> indices;
+    indices.reserve(quads * 6);
+    for (std::size_t quad = 0; quad < quads; ++quad) {
+        for (Index offset : kPattern) {
+            indices.push_back(static_cast<Index>(quad * 4 + offset));
+        }
+    }
+    if (!buffer.ebo) {
+        glGenBuffers(1, &buffer.ebo);
+    }
+    // 绑定到 GL_ELEMENT_ARRAY_BUFFER 会改写当前 VAO 的索引绑定，这里改用 GL_COPY_WRITE_BUFFER 上传
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER,
+                 static_cast<GLsizeiptr>(indices.size() * sizeof(Index)),
+                 indices.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    buffer.quads = quads;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+// QuadIndexBuffer: 所有 chunk VAO 共用的四边形索引缓冲（每个四边形 0,1,2,2,3,0）。
+// chunk mesh 只上传顶点；顶点数不超过 65536 的 mesh 用 16 位索引，更大的用 32 位索引。
+// 缓冲按需增长且始终保持同一个 GL 名字，已绑定它的 VAO 不需要重新设置。仅主线程使用。
+class QuadIndexBuffer {
+public:
+    static constexpr std::size_t kMaxShortQuads = 65536 / 4;
+
+    QuadIndexBuffer() = default;
+    ~QuadIndexBuffer();
+    QuadIndexBuffer(const QuadIndexBuffer&) = delete;
+    QuadIndexBuffer& operator=(const QuadIndexBuffer&) = delete;
+
+    // 确保能覆盖 quadCount 个四边形，并绑定到当前 VAO 的 GL_ELEMENT_ARRAY_BUFFER；返回索引类型
+    GLenum bind(std::size_t quadCount);
+
+    std::size_t gpuBytes() const;
+
+private:
+    struct Buffer {
+        GLuint ebo = 0;
+        std::size_t quads = 0;
+    };
+
+    template <typename Index>
+    static void grow(Buffer& buffer, std::size_t quadCount);
+
+    Buffer short_;
+    Buffer int_;
+};
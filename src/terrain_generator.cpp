@@ -0,0 +1,510 @@
+#include "terrain_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/noise.hpp>
+
+namespace {
+// fbm: 分形布朗运动（fractal brownian motion），用于生成地形高度噪声。
+// 参数：uv（采样坐标），octaves（迭代层数），lacunarity（频率倍增），gain（振幅衰减）。
+// 修改为 3D 以支持种子作为第三维，避免 2D 坐标直接加种子导致浮点精度丢失
+float fbm(glm::vec3 uv, int octaves, float lacunarity, float gain) {
+    float amplitude = 0.5f;
+    float frequency = 1.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < octaves; ++i) {
+        sum += amplitude * glm::perlin(uv * frequency);
+        frequency *= lacunarity;
+        amplitude *= gain;
+    }
+    return sum;
+}
+
+// Biome Definitions
+enum class BiomeType {
+    Ocean,
+    Beach,
+    Plains,
+    Forest,
+    Desert,
+    Mountains,
+    SnowyTundra,
+    Swamp
+};
+
+BiomeType getBiome(float temperature, float humidity, float heightScale) {
+    if (heightScale < -0.1f) return BiomeType::Ocean; // Low terrain is ocean
+    if (heightScale < -0.06f) return BiomeType::Beach;
+    
+    if (temperature > 0.5f) {
+        if (humidity < -0.2f) return BiomeType::Desert;
+        if (humidity > 0.2f) return BiomeType::Forest; // Jungle?
+        if (humidity > 0.0f && heightScale < 0.2f) return BiomeType::Swamp;
+        return BiomeType::Plains;
+    } else if (temperature < -0.4f) {
+        return BiomeType::SnowyTundra;
+    } else {
+        // Temperate
+        if (humidity > 0.3f || heightScale > 0.6f) return BiomeType::Forest;
+        if (heightScale > 0.8f) return BiomeType::Mountains;
+        if (humidity > 0.1f && heightScale < 0.2f) return BiomeType::Swamp;
+        return BiomeType::Plains;
+    }
+}
+
+// 随世界高度缩放的地形参数（128 高时与原先的硬编码值相同）
+constexpr float kTerrainScale = Chunk::Layout::TERRAIN_SCALE;
+constexpr float kMountainLift = 60.0f * kTerrainScale;                    // 山地抬升/起伏系数
+constexpr int kSnowLine = static_cast<int>(35.0f + 55.0f * kTerrainScale); // 高于此高度的山顶覆雪
+
+// 树生成参数（保持 generate 与 growTree 一致，避免树冠被 chunk 边界裁切）
+constexpr int kOakCanopyRadius = 4;      // growTree 水平最大扩展半径
+constexpr int kOakCanopyHalfHeight = 3;  // growTree 叶子层上下高度（dy: -2..2）
+// 树（含树冠）最高比地表高出的格数，见 growTree
+constexpr int kTreeHeadroom = 12;
+
+// 列顶（y == height）的方块：按群系与海岸决定的表层土，高山山顶覆雪
+BlockId surfaceBlock(int height, int waterLevel, BiomeType biome, float continental, float riverNoise) {
+    // Snow cap on tall mountains
+    if (height > kSnowLine) {
+        return BlockId::Snow;
+    }
+
+    // 1. Natural Beaches logic:
+    // Limit beaches to be near sea level AND near the ocean (low continentalness).
+    // This prevents inland rivers or puddles from becoming sandy beaches everywhere.
+    bool isBeachLevel = (height >= waterLevel - 2 && height <= waterLevel + 3);
+    bool isOceanCoast = (continental < 0.01f); // Threshold for coastlines
+
+    // 2. Biome specific overrides
+    BlockId id = BlockId::Grass;
+    if (biome == BiomeType::Desert) {
+        id = BlockId::Sand;
+    } else if (biome == BiomeType::SnowyTundra) {
+        // Cold areas have snow
+        id = BlockId::Snow;
+    } else if (isBeachLevel && isOceanCoast) {
+        // Only generate beaches at the actual ocean coast
+        id = BlockId::Sand;
+    }
+
+    // River bed is sand/gravel?
+    if (riverNoise > 0.5f && height < waterLevel) id = BlockId::Gravel;
+    return id;
+}
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(int seed, int waterLevel)
+    : seed_(seed),
+      waterLevel_(waterLevel) {}
+
+void TerrainGenerator::generate(Chunk& chunk) const {
+    // chunk 在世界坐标系的左下角（最小 x,z）位置；立方模式下 origin.y 为它的底层，
+    // 下面的地形按世界 y 判断，只写入落在本 chunk 内的那一段
+    glm::ivec3 origin = chunk.worldOrigin();
+
+    // 先生成地形（高度图），再生成植被。
+    // 这样可以：
+    // 1) 避免树的间距过滤受 (x,z) 扫描顺序影响而偏向同一角落
+    // 2) 让“边界预留”与树冠半径保持一致，避免树总是缺一半
+    std::array<std::array<int, Chunk::SIZE>, Chunk::SIZE> heights{};
+    std::array<std::array<BiomeType, Chunk::SIZE>, Chunk::SIZE> biomes{};
+    std::array<std::array<BlockId, Chunk::SIZE>, Chunk::SIZE> surfaces{};
+
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            int worldX = origin.x + x;
+            int worldZ = origin.z + z;
+            // 使用 seed 作为 Z 轴，避免 x/z 坐标数值过大导致浮点精度丢失
+            glm::vec3 uv = glm::vec3(worldX * 0.002f, worldZ * 0.002f, seed_ * 0.1337f);
+            
+            // 1. Biome Factors: Temperature & Humidity
+            float tempNoise = fbm(uv * 0.5f, 2, 2.0f, 0.5f); // Low freq
+            float humidNoise = fbm(uv * 0.5f + glm::vec3(123.4f), 2, 2.0f, 0.5f);
+            
+            // 2. Continentalness / Base Height
+            // Using larger scale noise for continents/mountains
+            float continental = fbm(uv * 0.3f, 3, 2.0f, 0.5f);
+            
+            // Determine Biome
+            BiomeType biome = getBiome(tempNoise, humidNoise, continental);
+            biomes[z][x] = biome;
+
+            // 3. Height Shaping based on Biome
+            
+            // 连续地形参数计算（基于大陆性噪声），消除群系间的断层
+            float baseHeight = 35.0f + continental * 10.0f; // 基础高度随大陆性线性变化
+            float amp = 6.0f; // 基础起伏
+
+            // 山地隆起：当 continental > 0.3 时开始抬升
+            if (continental > 0.3f) {
+                float t = (continental - 0.3f); 
+                baseHeight += t * kMountainLift; // 最大增加约 40-50（128 高时）
+                amp += t * kMountainLift;        // 山地起伏增大
+            } 
+            // 海洋下沉：当 continental < -0.1 时加速下降
+            else if (continental < -0.1f) {
+                float t = -(continental + 0.1f);
+                baseHeight -= t * 20.0f; // 深海
+            }
+
+            // 湿度对地表细节的微调（森林更粗糙）
+            if (humidNoise > 0.2f) {
+                amp += (humidNoise - 0.2f) * 10.0f;
+            }
+            
+            // Canyon/River Noise (Negative vein)
+            float riverNoise = std::abs(fbm(uv * 1.5f, 4, 2.0f, 0.5f));
+            riverNoise = 1.0f - glm::smoothstep(0.02f, 0.1f, riverNoise); // 1.0 inside river, 0.0 outside
+            
+            // Detail noise
+            float detail = fbm(uv * 2.0f, 4, 2.0f, 0.5f);
+            
+            int height = static_cast<int>(baseHeight + detail * amp);
+            
+            // Cut rivers
+            if (riverNoise > 0.0f) {
+                float riverDepth = 10.0f * riverNoise;
+                height = static_cast<int>(height - riverDepth);
+            }
+            // Clamp min heigh to bedrock
+            if (height < 1) height = 1;
+            heights[z][x] = height;
+
+            surfaces[z][x] = surfaceBlock(height, waterLevel_, biome, continental, riverNoise);
+        }
+    }
+
+    // 整段 16³ 分段快速填充：所有列共同的石头层以下直接写成 uniform(Stone)，
+    // 列顶与水面以上保持 uniform(Air)，逐体素写入只发生在剩余的过渡区间。
+    int minHeight = std::numeric_limits<int>::max();
+    int maxHeight = std::numeric_limits<int>::min();
+    for (const auto& row : heights) {
+        for (int h : row) {
+            minHeight = std::min(minHeight, h);
+            maxHeight = std::max(maxHeight, h);
+        }
+    }
+    // 立方模式：整个 chunk 在所有列顶、树冠与水面之上，保持全空气
+    if (origin.y > maxHeight + kTreeHeadroom && origin.y > waterLevel_) {
+        return;
+    }
+    const int stoneTop = minHeight - 3; // 所有列在 y < stoneTop 处都是石头
+    int solidSections = 0;
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        bool allStone = origin.y + (s + 1) * Chunk::SECTION_SIZE <= stoneTop;
+        chunk.fillSection(s, allStone ? BlockId::Stone : BlockId::Air);
+        if (allStone) solidSections = s + 1;
+    }
+    // 立方模式：整个 chunk 在石头层以下，没有地表也没有植被
+    if (solidSections == Chunk::SECTION_COUNT) {
+        return;
+    }
+    const int columnStart = solidSections * Chunk::SECTION_SIZE;
+
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            const int height = heights[z][x];
+            const BiomeType biome = biomes[z][x];
+            // y 为 chunk 局部坐标，worldY 才与高度、水面比较
+            const int columnTop = std::min(std::max(height, waterLevel_) - origin.y, Chunk::HEIGHT - 1);
+
+            for (int y = columnStart; y <= columnTop; ++y) {
+                const int worldY = origin.y + y;
+                BlockId id = BlockId::Air;
+                if (worldY <= height) {
+                    if (worldY == height) {
+                        // Top Soil Logic (snow caps included)
+                        id = surfaces[z][x];
+                    } else if (worldY >= height - 3) {
+                        // Sub Soil
+                        if (biome == BiomeType::Desert || biome == BiomeType::Beach) id = BlockId::Sand;
+                        else id = BlockId::Dirt;
+                    } else {
+                        // Stone
+                        id = BlockId::Stone;
+                    }
+                } else if (worldY <= waterLevel_) {
+                    id = BlockId::Water;
+                    // Winter freezes water?
+                    if (biome == BiomeType::SnowyTundra && worldY == waterLevel_) id = BlockId::Snow; // Ice ideally
+                }
+                chunk.setBlock(x, y, z, id);
+            }
+        }
+    }
+
+    // 植被生成：为避免“扫描顺序偏置”，对候选格做确定性打乱。
+    std::vector<std::pair<int, int>> cells;
+    cells.reserve(static_cast<std::size_t>(Chunk::SIZE * Chunk::SIZE));
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            cells.emplace_back(x, z);
+        }
+    }
+    // 基于 chunk 坐标的确定性 Fisher–Yates shuffle
+    for (int i = static_cast<int>(cells.size()) - 1; i > 0; --i) {
+        float r = noiseRand(origin.x, origin.z, 4200 + i);
+        int j = static_cast<int>(r * static_cast<float>(i + 1));
+        if (j < 0) j = 0;
+        if (j > i) j = i;
+        std::swap(cells[static_cast<std::size_t>(i)], cells[static_cast<std::size_t>(j)]);
+    }
+
+    const int spacing = 7; // 树之间的最小间距（方形邻域半径）
+    const int margin = kOakCanopyRadius; // 确保树冠不会越出 chunk
+    // 已种树干的位置：每个 z 行一个掩码（bit x），邻域检查只需按行做一次按位与
+    std::array<std::uint32_t, Chunk::SIZE> trunkRows{};
+
+    for (const auto& cell : cells) {
+        int x = cell.first;
+        int z = cell.second;
+        int height = heights[z][x];
+        int worldX = origin.x + x;
+        int worldZ = origin.z + z;
+        BiomeType biome = biomes[z][x];
+
+        // 树：水面以上才生成
+        if (height > waterLevel_ + 2) {
+            // 预留足够边界，避免树冠跨出 chunk 被裁切
+            bool inside = (x >= margin && x < Chunk::SIZE - margin && z >= margin && z < Chunk::SIZE - margin);
+            if (inside && (biome == BiomeType::Forest || biome == BiomeType::Plains || biome == BiomeType::Swamp || biome == BiomeType::SnowyTundra)) {
+                
+                // Determine Tree Density Map
+                float treeMask = glm::perlin(glm::vec3(worldX * 0.005f, worldZ * 0.005f, seed_ * 0.1337f));
+                float baseProb = 0.01f; 
+                if (biome == BiomeType::Forest) baseProb = 0.12f; // Increased significantly for dense forests
+                else if (biome == BiomeType::Plains) baseProb = 0.005f;
+                
+                float treeProb = glm::mix(baseProb * 0.1f, baseProb * 2.0f, treeMask * 0.5f + 0.5f);
+                
+                // Use pure white noise for placement to avoid grid artifacts
+                bool treeChance = noiseRand(worldX, worldZ, 911) < treeProb;
+
+                if (treeChance) {
+                    // Check radius (smaller radius for forests allows denser packing)
+                    int checkR = (biome == BiomeType::Forest) ? 3 : 6;
+                    int x0 = glm::max(x - checkR, 0);
+                    int x1 = glm::min(x + checkR, Chunk::SIZE - 1);
+                    std::uint32_t rowMask = ((std::uint32_t{1} << (x1 + 1)) - 1) & ~((std::uint32_t{1} << x0) - 1);
+                    bool hasNeighborTree = false;
+                    for (int nz = glm::max(z - checkR, 0); nz <= glm::min(z + checkR, Chunk::SIZE - 1); ++nz) {
+                        if (trunkRows[nz] & rowMask) {
+                            hasNeighborTree = true;
+                            break;
+                        }
+                    }
+                    if (!hasNeighborTree) {
+                        growTree(chunk, x, z, worldX, worldZ, height);
+                        trunkRows[z] |= std::uint32_t{1} << x;
+                        continue; // Tree takes spot
+                    }
+                }
+            }
+        }
+
+        // --- Vegetation (Flowers / Grass) ---
+        // Requirement: "Interweaved random growth", not "patches".
+        // Implementation:
+        // 1. Use a low-freq noise to determine "Patch Density" (Is this a lush area?)
+        // 2. Use high-freq white noise to determine "Placement" (Individual plant)
+        // 3. Use another white noise to determine "Type" (Flower A vs Flower B)
+        
+        // 植物所在的局部 y；立方模式下它可能落在上面的 chunk 里，由那个 chunk 生成。
+        // 土壤直接取 surfaces（列顶可能在下面的 chunk 里）；列顶方块中只有雪会被树叶覆盖，两者都不长植物
+        const int plantY = height + 1 - origin.y;
+        if (height > waterLevel_ + 1 && plantY >= 0 && plantY < Chunk::HEIGHT &&
+            chunk.block(x, plantY, z) == BlockId::Air) {
+             BlockId soil = surfaces[z][x];
+             // Logic based on biome
+             if (biome == BiomeType::Desert && soil == BlockId::Sand) {
+                 if (noiseRand(worldX, worldZ, 777) < 0.005f) {
+                     chunk.setBlock(x, plantY, z, BlockId::Cactus);
+                     // Add logic for taller cactus?
+                 } else if (noiseRand(worldX, worldZ, 778) < 0.01f) {
+                    chunk.setBlock(x, plantY, z, BlockId::DeadBush);
+                 }
+             }
+             else if (soil == BlockId::Grass) { // Plains, Forest, Mountains
+                 float lushNoise = glm::perlin(glm::vec3(worldX * 0.05f, worldZ * 0.05f, seed_ * 0.1337f));  // Medium freq
+                 float lushFactor = lushNoise * 0.5f + 0.5f; // 0..1
+                 
+                 // Biome multiplier
+                 float density = 0.05f; // Base density
+                 if (biome == BiomeType::Forest) density = 0.15f; // Grassier
+                 if (biome == BiomeType::Plains) density = 0.3f;  // Very grassy/flowery
+                 
+                 // Local density modification
+                 float prob = density * lushFactor;
+                 
+                 // Roll for plant
+                 if (noiseRand(worldX, worldZ, 333) < prob) {
+                     // Pick Type: Grass or Flower?
+                     // 70% Grass, 30% Flower in Plains. 90% Grass in Forest.
+                     float flowerRatio = (biome == BiomeType::Plains) ? 0.3f : 0.05f;
+                     
+                     if (noiseRand(worldX, worldZ, 444) < flowerRatio) {
+                         // Pick specific flower (Interweaved mix)
+                         float typeR = noiseRand(worldX, worldZ, 555);
+                         BlockId flower = BlockId::Flower; // Poppy default
+                         
+                         // Palette: Poppy, Dandelion, AzureBluet, Tulips, etc.
+                         // Weighted selection
+                         if (typeR < 0.2f) flower = BlockId::Dandelion;
+                         else if (typeR < 0.3f) flower = BlockId::Flower; // Poppy
+                         else if (typeR < 0.4f) flower = BlockId::AzureBluet;
+                         else if (typeR < 0.5f) flower = BlockId::RedTulip;
+                         else if (typeR < 0.6f) flower = BlockId::OrangeTulip;
+                         else if (typeR < 0.7f) flower = BlockId::WhiteTulip;
+                         else if (typeR < 0.8f) flower = BlockId::PinkTulip;
+                         else if (typeR < 0.9f) flower = BlockId::OxeyeDaisy;
+                         else flower = BlockId::Cornflower;
+                         
+                         // Rare chance for rare flowers
+                         if (noiseRand(worldX, worldZ, 666) < 0.01f) {
+                             flower = BlockId::LilyOfTheValley;
+                         }
+                         if (biome == BiomeType::Swamp && typeR < 0.5f) flower = BlockId::BlueOrchid;
+
+                         chunk.setBlock(x, plantY, z, flower);
+                     } else {
+                         // Tall Grass
+                         chunk.setBlock(x, plantY, z, BlockId::TallGrass);
+                     }
+                 }
+             }
+        }
+    }
+
+    // 植被/树冠可能覆盖掉先写入的方块，压缩调色板以回收多余位宽
+    chunk.compactStorage();
+}
+
+float TerrainGenerator::noiseRand(int x, int z, int salt) const {
+    // Integer hash to avoid floating point precision issues with large seeds
+    unsigned int h = (unsigned int)x * 374761393U + (unsigned int)z * 668265263U + (unsigned int)seed_ + (unsigned int)salt;
+    h = (h ^ (h >> 13)) * 1274126177U;
+    h = h ^ (h >> 16);
+    return (h & 0x7FFFFFFF) / 2147483647.0f;
+}
+
+// growTree: 在指定位置生成树干与树冠（简单体素树）
+// 参数说明见函数签名：chunk（目标 chunk），localX/localZ（chunk 局部 x/z），
+// worldX/worldZ（世界 x/z，用于随机函数），groundHeight（地表高度，世界 y）
+// 立方模式下同一棵树在它跨过的每个 chunk 里都按同样的随机数完整走一遍，只写入落在本 chunk 内的部分
+void TerrainGenerator::growTree(Chunk& chunk, int localX, int localZ, int worldX, int worldZ, int groundHeight) const {
+    int baseY = groundHeight + 1; 
+    if (!Chunk::CUBIC && baseY + kTreeHeadroom >= Chunk::HEIGHT) return;
+    const int originY = chunk.worldOrigin().y;
+
+    // Deterministic Randomness
+    float rType = noiseRand(worldX, worldZ, 666);
+    float rHeight = noiseRand(worldX, worldZ, 123);
+    
+    // Style distribution:
+    // 0: Classic Oak (Blob) - 40%
+    // 1: Tall / Double Blob - 20%
+    // 2: Pine / Conical - 20%
+    // 3: Wide / Flat - 20%
+    int style = 0;
+    if (rType < 0.40f) style = 0;
+    else if (rType < 0.60f) style = 1;
+    else if (rType < 0.80f) style = 2;
+    else style = 3;
+
+    // Determine Trunk Height
+    int height = 4 + (int)(rHeight * 3.5f); // 4 to 7
+    if (style == 1) height += 2; // Tall trees need more height (6-9)
+    if (style == 2) height += 1; // Pines are slightly taller
+
+    // Helper: Safe Set
+    auto setIfReplaceable = [&](int x, int worldY, int z, BlockId id) {
+        const int y = worldY - originY;
+        if (x < 0 || x >= Chunk::SIZE || z < 0 || z >= Chunk::SIZE || y < 0 || y >= Chunk::HEIGHT) return;
+        BlockId current = chunk.block(x, y, z);
+        if (current == BlockId::Air || current == BlockId::TallGrass || current == BlockId::Flower || 
+            current == BlockId::OakLeaves || current == BlockId::Snow || current == BlockId::Water) {
+            chunk.setBlock(x, y, z, id);
+        }
+    };
+
+    // 1. Generate Trunk
+    for (int i = 0; i < height; ++i) {
+        setIfReplaceable(localX, baseY + i, localZ, BlockId::OakLog);
+    }
+
+    int topY = baseY + height - 1;
+
+    // Helper: Draw Leaf Blob
+    auto drawBlob = [&](int cx, int cy, int cz, float radius) {
+        int rCeil = (int)ceil(radius);
+        for (int dy = -rCeil; dy <= rCeil; ++dy) {
+            for (int dx = -rCeil; dx <= rCeil; ++dx) {
+                for (int dz = -rCeil; dz <= rCeil; ++dz) {
+                    float distSq = (float)(dx*dx + dy*dy + dz*dz);
+                    // Add noise to radius to make it organic/irregular
+                    float noise = noiseRand(worldX + dx, worldZ + dz, cy + dy) * 1.5f - 0.75f; 
+                    if (distSq <= (radius + noise) * (radius + noise)) {
+                        setIfReplaceable(cx + dx, cy + dy, cz + dz, BlockId::OakLeaves);
+                    }
+                }
+            }
+        }
+    };
+
+    // 2. Generate Canopy
+    if (style == 0) { 
+        // --- Classic Oak (Irregular Blob) ---
+        drawBlob(localX, topY - 1, localZ, 2.5f);
+    } 
+    else if (style == 1) { 
+        // --- Tall / Double Blob ---
+        drawBlob(localX, topY, localZ, 2.0f);   // Top small blob
+        drawBlob(localX, topY - 3, localZ, 2.8f); // Lower big blob
+    }
+    else if (style == 2) { 
+        // --- Pine / Conical ---
+        // Tip
+        setIfReplaceable(localX, topY + 1, localZ, BlockId::OakLeaves);
+        // Layers
+        int layers = height - 2;
+        for (int i = 0; i < layers; ++i) {
+            int y = topY - i;
+            float progress = (float)i / (float)layers; // 0 (top) to 1 (bottom)
+            int radius = 1 + (int)(progress * 2.5f); // 1 to 3
+            
+            for (int dx = -radius; dx <= radius; ++dx) {
+                for (int dz = -radius; dz <= radius; ++dz) {
+                    if (dx*dx + dz*dz <= radius*radius + 1) {
+                         // Ragged edges: 20% chance to skip block
+                         if (noiseRand(worldX + dx, worldZ + dz, y) > 0.2f)
+                            setIfReplaceable(localX + dx, y, localZ + dz, BlockId::OakLeaves);
+                    }
+                }
+            }
+        }
+    }
+    else { 
+        // --- Wide / Flat ---
+        // 2-3 layers, very wide
+        for (int y = topY - 1; y <= topY + 1; ++y) {
+            int radius = (y == topY) ? 2 : 3;
+            if (y == topY + 1) radius = 1; // Small top
+            
+            for (int dx = -radius; dx <= radius; ++dx) {
+                for (int dz = -radius; dz <= radius; ++dz) {
+                     float dist = sqrt(dx*dx + dz*dz);
+                     if (dist <= radius + 0.4f) {
+                         setIfReplaceable(localX + dx, y, localZ + dz, BlockId::OakLeaves);
+                     }
+                }
+            }
+        }
+    }
+}
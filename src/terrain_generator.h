@@ -0,0 +1,26 @@
+#pragma once
+
+#include "chunk.h"
+
+// TerrainGenerator: 由种子确定的地形与植被生成（高度图、表面方块、水、树、花草）。
+// 不依赖 GL 与 World 的其它状态，同样的种子和坐标总是生成同样的 chunk，
+// 因此也可以在基准测试里直接使用。
+class TerrainGenerator {
+public:
+    TerrainGenerator(int seed, int waterLevel);
+
+    // 在 chunk（应为全空气）中按其坐标生成地形
+    void generate(Chunk& chunk) const;
+
+    // 基于整数哈希的确定性随机数 [0,1]
+    float noiseRand(int x, int z, int salt) const;
+
+    int seed() const { return seed_; }
+    int waterLevel() const { return waterLevel_; }
+
+private:
+    void growTree(Chunk& chunk, int localX, int localZ, int worldX, int worldZ, int groundHeight) const;
+
+    int seed_;
+    int waterLevel_;
+};
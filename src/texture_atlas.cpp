@@ -105,6 +105,7 @@ bool TextureAtlas::build(const std::vector<AtlasTexture>& textures) {
     
     // Allocate 3D storage: width, height, layers
     glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, tileSize_, tileSize_, totalFrames, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    layerCount_ = totalFrames;
 
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -152,6 +153,17 @@ bool TextureAtlas::build(const std::vector<AtlasTexture>& textures) {
     return true;
 }
 
+std::size_t TextureAtlas::gpuBytes() const {
+    if (textureId_ == 0) {
+        return 0;
+    }
+    std::size_t bytes = 0;
+    for (int size = tileSize_; size > 0; size /= 2) {
+        bytes += static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4u;
+    }
+    return bytes * static_cast<std::size_t>(layerCount_);
+}
+
 void TextureAtlas::bind(int unit) const {
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_2D_ARRAY, textureId_);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <string>
 #include <unordered_map>
@@ -37,12 +38,15 @@ public:
     unsigned int id() const { return textureId_; }
     int atlasWidth() const { return atlasWidth_; }
     int atlasHeight() const { return atlasHeight_; }
+    // 纹理数组在 GPU 上的字节数（RGBA8，含完整 mipmap 链）
+    std::size_t gpuBytes() const;
 
 private:
     unsigned int textureId_ = 0;
     int tileSize_ = 0;
     int atlasWidth_ = 0;
     int atlasHeight_ = 0;
+    int layerCount_ = 0;
 
     std::vector<glm::vec4> uvRects_;
     std::unordered_map<std::string, int> keyToIndex_;
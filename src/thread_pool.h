@@ -0,0 +1,34 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool: 固定数量的工作线程 + 一个 FIFO 任务队列。
+// 任务不得调用 GL（上下文只在主线程上）；析构时丢弃尚未开始的任务并等待正在执行的任务结束。
+class ThreadPool {
+public:
+    // threadCount 为 0 时取硬件线程数减一（给主线程留一个核），至少 1 个
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    std::size_t threadCount() const { return workers_.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
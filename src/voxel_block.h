@@ -3,6 +3,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -57,6 +58,7 @@ struct BlockInfo {
     float emission = 0.0f;
     float material = 0.0f;
     BlockAnimation animation;
+    int animationSlot = 0; // 0 为无动画，否则为 BlockRegistry::animations() 的下标 + 1
 };
 
 class TextureAtlas;
@@ -68,8 +70,13 @@ public:
     void build(const TextureAtlas& atlas);
     const BlockInfo& info(BlockId id) const { return blocks_[static_cast<std::size_t>(id)]; }
     bool occludes(BlockId id) const;
+    // 各动画槽的帧数与速度，chunk 顶点只记录槽号，由 chunk.vert 查 uAnimations 表
+    const std::vector<BlockAnimation>& animations() const { return animations_; }
+
+    static constexpr int kMaxAnimations = 15;
 
 private:
     BlockInfo& slot(BlockId id) { return blocks_[static_cast<std::size_t>(id)]; }
     std::array<BlockInfo, static_cast<int>(BlockId::Count)> blocks_;
+    std::vector<BlockAnimation> animations_;
 };
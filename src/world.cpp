@@ -2,11 +2,13 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/constants.hpp>
-#include <glm/gtc/noise.hpp>
 #include <glm/gtx/norm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -34,57 +36,23 @@ inline int floorDiv(int value, int divisor) {
     return div;
 }
 
-// fbm: 分形布朗运动（fractal brownian motion），用于生成地形高度噪声。
-// 参数：uv（采样坐标），octaves（迭代层数），lacunarity（频率倍增），gain（振幅衰减）。
-// 修改为 3D 以支持种子作为第三维，避免 2D 坐标直接加种子导致浮点精度丢失
-float fbm(glm::vec3 uv, int octaves, float lacunarity, float gain) {
-    float amplitude = 0.5f;
-    float frequency = 1.0f;
-    float sum = 0.0f;
-    for (int i = 0; i < octaves; ++i) {
-        sum += amplitude * glm::perlin(uv * frequency);
-        frequency *= lacunarity;
-        amplitude *= gain;
-    }
-    return sum;
+// 云层高度（Y），随世界高度缩放（128 高时与原先的硬编码值相同）
+constexpr float kCloudHeight = 35.0f + 55.0f * Chunk::Layout::TERRAIN_SCALE;
+
+// chunk 偏移 (dx, dy, dz) 是否落在半径 radius 的球内（取 (r+0.5)^2 让轴向端点保留下来），
+// 且 |dy| 不超过 verticalRadius；整列模式 dy 与 verticalRadius 恒为 0，即水平的圆
+inline bool withinRadius(int dx, int dy, int dz, int radius, int verticalRadius) {
+    return std::abs(dy) <= verticalRadius && dx * dx + dy * dy + dz * dz <= radius * radius + radius;
 }
 
-// Biome Definitions
-enum class BiomeType {
-    Ocean,
-    Beach,
-    Plains,
-    Forest,
-    Desert,
-    Mountains,
-    SnowyTundra,
-    Swamp
-};
+// 卸载半径比加载半径多出的 chunk 数，来回走动时不会在边界上反复加载/卸载
+constexpr int kUnloadMargin = 2;
 
-BiomeType getBiome(float temperature, float humidity, float heightScale) {
-    if (heightScale < -0.1f) return BiomeType::Ocean; // Low terrain is ocean
-    if (heightScale < -0.06f) return BiomeType::Beach;
-    
-    if (temperature > 0.5f) {
-        if (humidity < -0.2f) return BiomeType::Desert;
-        if (humidity > 0.2f) return BiomeType::Forest; // Jungle?
-        if (humidity > 0.0f && heightScale < 0.2f) return BiomeType::Swamp;
-        return BiomeType::Plains;
-    } else if (temperature < -0.4f) {
-        return BiomeType::SnowyTundra;
-    } else {
-        // Temperate
-        if (humidity > 0.3f || heightScale > 0.6f) return BiomeType::Forest;
-        if (heightScale > 0.8f) return BiomeType::Mountains;
-        if (humidity > 0.1f && heightScale < 0.2f) return BiomeType::Swamp;
-        return BiomeType::Plains;
-    }
+// Y 方向的卸载半径：立方模式同样多留 kUnloadMargin，整列模式只有一层
+inline int verticalUnloadRadius(int verticalRadius) {
+    return Chunk::CUBIC ? verticalRadius + kUnloadMargin : 0;
 }
 
-// 树生成参数（保持 generateTerrain 与 growTree 一致，避免树冠被 chunk 边界裁切）
-constexpr int kOakCanopyRadius = 4;      // growTree 水平最大扩展半径
-constexpr int kOakCanopyHalfHeight = 3;  // growTree 叶子层上下高度（dy: -2..2）
-
 } // namespace
 
 // CloudLayer: 负责生成、更新和绘制天空云层的简单网格与偏移动画。
@@ -324,7 +292,7 @@ struct World::AnimalMesh {
 // 顶点包含 pos/normal/uv/color/light/material/anim（RenderVertex）。
 World::CloudLayer::CloudLayer() {
     const float half = 1024.0f;     // 云层在 X/Z 方向上的半径（世界单位）
-    const float height = 90.0f;     // 云层高度（世界单位，Y）
+    const float height = kCloudHeight; // 云层高度（世界单位，Y）
     RenderVertex verts[4];
     unsigned int indices[6] = {0, 1, 2, 2, 3, 0};
     glm::vec3 positions[4] = {
@@ -465,8 +433,12 @@ struct World::SunMesh {
   clouds_       : CloudLayer 的唯一指针，管理云层。
   sunMesh_      : SunMesh 的唯一指针，绘制太阳 billboard。
   boundsVao_/Vbo_: 用于调试时绘制 chunk 边界线的 OpenGL 缓冲。
-  chunks_       : 存放当前加载的 chunk 的 unordered_map，键为 ChunkCoord，值为 unique_ptr<Chunk>。
-  meshQueue_    : 需要重建 mesh 的 chunk 坐标队列（按帧处理一定数量）。
+  chunks_       : 存放当前加载的 chunk 的环形网格（ChunkGrid），窗口覆盖卸载半径 renderDistance_+2
+                  （立方 chunk 模式下 Y 方向覆盖 verticalRenderDistance()+2）。
+  chunkPool_    : 卸载的 chunk 回收到这里，加载时优先复用（体素缓冲与 GL 句柄都保留）。
+  meshQueue_    : 需要重建 mesh 的 chunk（MeshScheduler，按坐标去重并排优先级）；rebuildMeshes 为各 chunk
+                  的脏分段拍快照后交给 meshWorkers_ 构建，完成的结果放进 meshResults_，由主线程按时间预算上传；
+                  上传完的输出进入 spareMeshes_，供之后的构建复用其数组容量。
   cameraPos_    : 当前相机在世界坐标系的位置（x,y,z）。
   renderDistance_: 渲染半径（以 chunk 为单位）。
   sunDir_       : 太阳方向（单位向量）。
@@ -480,9 +452,11 @@ World::World(TextureAtlas& atlas,
              const AnimalUVLayout& pigUV,
              const AnimalUVLayout& cowUV,
              const AnimalUVLayout& sheepUV,
-             int seed)
+             int seed,
+             int renderDistance)
     : atlas_(atlas),
       registry_(registry),
+      renderDistance_(std::clamp(renderDistance, 1, kMaxRenderDistance)),
       seed_(seed),
       clouds_(std::make_unique<CloudLayer>()),
       sunMesh_(std::make_unique<SunMesh>()),
@@ -491,6 +465,11 @@ World::World(TextureAtlas& atlas,
     sheepMesh_(std::make_unique<AnimalMesh>(AnimalType::Sheep, sheepUV, glm::vec3(1.0f)))
 {
     (void)atlas_;
+    // chunk 网格窗口覆盖卸载半径（cleanupChunks 保留 renderDistance_+2 以内的 chunk）
+    const int verticalLimit = verticalUnloadRadius(verticalRenderDistance());
+    chunks_.resize(renderDistance_ + kUnloadMargin, verticalLimit);
+    // 直线移动时每步卸载一整条边（窗口宽度个 chunk，立方模式再乘以层数），空闲列表留两条边的余量
+    chunkPool_.setMaxFree(static_cast<std::size_t>(2 * (2 * (renderDistance_ + kUnloadMargin) + 1) * (2 * verticalLimit + 1)));
     // 创建用于绘制 chunk 边界线的 VAO/VBO 并设置顶点布局（位置/法线/uv/color/light/material/anim）
     glGenVertexArrays(1, &boundsVao_);
     glGenBuffers(1, &boundsVbo_);
@@ -527,7 +506,9 @@ void World::update(const glm::vec3& cameraPos, float dt) {
     updateSun(dt);
     // 确保相机周围一定范围内的 chunk 被生成/存在
     ensureChunksAround(cameraPos_);
-    // 重建需要更新的 chunk 网格（每帧限制数量）
+    // 相机移动后远近变化的 chunk 换用对应 LOD 的网格
+    updateLods();
+    // 上传已完成的 mesh，并把需要更新的 chunk 派发给工作线程
     rebuildMeshes();
     // 清理远处不需要的 chunk
     cleanupChunks(cameraPos_);
@@ -539,37 +520,120 @@ void World::update(const glm::vec3& cameraPos, float dt) {
     updateAnimals(dt);
 }
 
-void World::render(const Shader& shader) const {
-    // 渲染所有非透明（solid）的 chunk
-    for (const auto& [coord, chunk] : chunks_) {
-        if (!chunk || chunk->empty()) {
-            continue;
+void World::render(const Shader& chunkShader, const Shader& shader, const Frustum* frustum, const glm::vec3* eye) const {
+    // 渲染所有非透明（solid）的 chunk；包围盒只覆盖非空气层，
+    // 因此抬头看天或在深处俯视时，视锥上下之外的 chunk 会被整块跳过
+    chunkShader.use();
+    int drawn = 0;
+    std::size_t drawnQuads = 0;
+    std::size_t visibleQuads = 0;
+    chunks_.forEach([&](const Chunk& chunk) {
+        if (chunk.empty()) {
+            return;
+        }
+        if (frustum && !frustum->intersects(chunk.meshBoundsMin(), chunk.meshBoundsMax())) {
+            return;
         }
-        chunk->renderSolid();
+        // 顶点为 chunk 局部坐标
+        chunkShader.setVec3("uChunkOrigin", glm::vec3(chunk.worldOrigin()));
+        drawnQuads += chunk.renderSolid(eye);
+        visibleQuads += chunk.solidQuadCount();
+        ++drawn;
+    });
+    if (frustum) {
+        drawnChunks_ = drawn;
+        drawnSolidQuads_ = drawnQuads;
+        visibleSolidQuads_ = visibleQuads;
+        viewFrustum_ = *frustum;
     }
 
     // 渲染动物
+    shader.use();
+    renderAnimals(shader);
+}
+
+void World::renderShadows(const Shader& chunkShader, const Shader& shader, const glm::mat4& lightSpace) const {
+    // 正交投影体外的几何在光栅化时本就被裁掉，按它剔除不会丢失投影体
+    const Frustum lightFrustum(lightSpace);
+    chunkShader.use();
+    chunks_.forEach([&](const Chunk& chunk) {
+        if (chunk.empty() || !lightFrustum.intersects(chunk.meshBoundsMin(), chunk.meshBoundsMax())) {
+            return;
+        }
+        chunkShader.setVec3("uChunkOrigin", glm::vec3(chunk.worldOrigin()));
+        chunk.renderSolid(nullptr);
+    });
+
+    shader.use();
     renderAnimals(shader);
 }
 
-void World::renderTransparent(const Shader&) const {
-    // 透明物体需按距离逆序渲染：先计算每个 chunk 到相机在 XZ 平面的平方距离
-    std::vector<std::pair<float, Chunk*>> transparent;
+// transparentOrder: 视锥内的非空 chunk，按到相机的距离从远到近排列（透明物体需逆序渲染）
+std::vector<const Chunk*> World::transparentOrder(const Frustum* frustum) const {
+    // 先计算每个 chunk（的最小角）到相机的平方距离；整列 chunk 的 y 都是 0，等同于按 XZ 平面距离排序
+    std::vector<std::pair<float, const Chunk*>> transparent;
     transparent.reserve(chunks_.size());
-    for (const auto& [coord, chunk] : chunks_) {
-        if (!chunk) continue;
+    chunks_.forEach([&](const Chunk& chunk) {
+        if (chunk.empty() ||
+            (frustum && !frustum->intersects(chunk.meshBoundsMin(), chunk.meshBoundsMax()))) {
+            return;
+        }
         // 使用 squared distance 避免开方开销
-        transparent.emplace_back(glm::length2(glm::vec2(cameraPos_.x - coord.x * Chunk::SIZE,
-                                                        cameraPos_.z - coord.z * Chunk::SIZE)),
-                                 chunk.get());
-    }
+        transparent.emplace_back(glm::length2(cameraPos_ - glm::vec3(chunk.worldOrigin())), &chunk);
+    });
     // 按距离从远到近排序
     std::sort(transparent.begin(), transparent.end(), [](const auto& a, const auto& b) {
         return a.first > b.first;
     });
+    std::vector<const Chunk*> order;
+    order.reserve(transparent.size());
     for (const auto& pair : transparent) {
-        pair.second->renderAlpha();
+        order.push_back(pair.second);
     }
+    return order;
+}
+
+void World::renderLiquids(const Shader& chunkShader, const Frustum* frustum) const {
+    chunkShader.use();
+    for (const Chunk* chunk : transparentOrder(frustum)) {
+        chunkShader.setVec3("uChunkOrigin", glm::vec3(chunk->worldOrigin()));
+        chunk->renderLiquid();
+    }
+}
+
+void World::renderTransparent(const Shader& chunkShader, const Frustum* frustum) const {
+    chunkShader.use();
+    for (const Chunk* chunk : transparentOrder(frustum)) {
+        chunkShader.setVec3("uChunkOrigin", glm::vec3(chunk->worldOrigin()));
+        chunk->renderAlpha();
+    }
+}
+
+void World::renderBillboards(const Shader& billboardShader, const Frustum* frustum) const {
+    // 植物只在近处看得清，远处的 chunk 连同其实例一起跳过；距离取相机到 chunk 在 XZ 平面上的最近点
+    // （立方模式下取三维最近点，上下远处的 chunk 同样跳过）
+    const float maxDistance2 = billboardDistance_ * billboardDistance_;
+    std::size_t drawn = 0;
+    billboardShader.use();
+    chunks_.forEach([&](const Chunk& chunk) {
+        if (chunk.billboardCount() == 0) {
+            return;
+        }
+        const glm::vec3 origin(chunk.worldOrigin());
+        const float dx = cameraPos_.x - std::clamp(cameraPos_.x, origin.x, origin.x + static_cast<float>(Chunk::SIZE));
+        const float dz = cameraPos_.z - std::clamp(cameraPos_.z, origin.z, origin.z + static_cast<float>(Chunk::SIZE));
+        const float dy = Chunk::CUBIC ? cameraPos_.y - std::clamp(cameraPos_.y, origin.y, origin.y + static_cast<float>(Chunk::HEIGHT)) : 0.0f;
+        if (dx * dx + dy * dy + dz * dz > maxDistance2) {
+            return;
+        }
+        if (frustum && !frustum->intersects(chunk.meshBoundsMin(), chunk.meshBoundsMax())) {
+            return;
+        }
+        billboardShader.setVec3("uChunkOrigin", glm::vec3(chunk.worldOrigin()));
+        chunk.renderBillboards();
+        drawn += chunk.billboardCount();
+    });
+    drawnBillboards_ = drawn;
 }
 
 void World::renderChunkBounds(const Shader&) {
@@ -599,9 +663,8 @@ void World::renderChunkBounds(const Shader&) {
     };
 
     // 遍历所有 chunk，构建对应的 12 条边的线段
-    for (const auto& [coord, chunk] : chunks_) {
-        if (!chunk) continue;
-        glm::vec3 min = glm::vec3(coord.x * Chunk::SIZE, 0.0f, coord.z * Chunk::SIZE);
+    chunks_.forEach([&](const Chunk& chunk) {
+        glm::vec3 min = glm::vec3(chunk.worldOrigin());
         glm::vec3 max = min + glm::vec3(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
         glm::vec3 corners[8] = {
             {min.x, min.y, min.z},
@@ -621,7 +684,7 @@ void World::renderChunkBounds(const Shader&) {
         for (auto& edge : edges) {
             pushLine(corners[edge[0]], corners[edge[1]]);
         }
-    }
+    });
 
     if (boundsVertices_.empty()) {
         return;
@@ -674,13 +737,13 @@ void World::renderSun(const Shader& shader) const {
 // dir: 单位方向向量
 // maxDistance: 最大检测距离
 RayHit World::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance) const {
-    auto sampler = [this](const glm::ivec3& pos) { return blockAt(pos); };
-    return RaycastBlocks(origin, dir, maxDistance, sampler, registry_);
+    BlockAccessor accessor = blockAccessor(glm::ivec3(glm::floor(origin)));
+    return RaycastBlocks(origin, dir, maxDistance, accessor, registry_);
 }
 
 // setBlockInternal / placeBlock / removeBlock:
 // 这些函数处理世界坐标到 chunk/local 的映射，修改 chunk 内容并把对应 chunk 标记为 dirty。
-// meshQueue_ 会在下帧被处理以重新构建 mesh，从而把修改反映到渲染数据上。
+// meshQueue_ 会在下帧以编辑优先级处理（先于加载任务）以重新构建 mesh，从而把修改反映到渲染数据上。
 
 bool World::removeBlock(const glm::ivec3& pos) {
     return setBlockInternal(pos, BlockId::Air);
@@ -693,17 +756,77 @@ bool World::placeBlock(const glm::ivec3& pos, BlockId id) {
 // blockAt: 在世界坐标 pos 处查询方块 ID。
 // 如果坐标不在已加载的 chunk 中则返回 Air（空气）。
 BlockId World::blockAt(const glm::ivec3& pos) const {
-    if (pos.y < 0 || pos.y >= Chunk::HEIGHT) {
+    // 整列模式下世界高度之外都是空气；立方模式没有上下限，只看对应 chunk 是否已加载
+    if (!Chunk::inWorldHeight(pos.y)) {
         return BlockId::Air;
     }
-    // worldToChunk: 把世界 x,z 投影为 chunk 坐标（整格）
-    ChunkCoord coord = worldToChunk(pos.x, pos.z);
-    auto it = chunks_.find(coord);
-    if (it == chunks_.end() || !it->second) {
+    // worldToChunk: 把世界坐标投影为 chunk 坐标（整格，整列模式只看 x,z）
+    ChunkCoord coord = worldToChunk(pos);
+    const Chunk* chunk = chunks_.find(coord);
+    if (!chunk) {
         return BlockId::Air;
     }
     glm::ivec3 local = toLocal(pos, coord); // toLocal: 把世界坐标转为 chunk 内部局部坐标
-    return it->second->block(local.x, pos.y, local.z);
+    return chunk->block(local.x, local.y, local.z);
+}
+
+BlockAccessor World::blockAccessor(const glm::ivec3& hint) const {
+    return BlockAccessor(chunks_, chunks_.find(worldToChunk(hint)));
+}
+
+// isRangeEmpty: 按 chunk 切分世界坐标区间，逐个 chunk 用列占用位图判断
+bool World::isRangeEmpty(const glm::ivec3& min, const glm::ivec3& max, Chunk::Occupancy kind) const {
+    if (min.x > max.x || min.y > max.y || min.z > max.z ||
+        (!Chunk::CUBIC && (max.y < 0 || min.y >= Chunk::HEIGHT))) {
+        return true;
+    }
+    ChunkCoord c0 = worldToChunk(min);
+    ChunkCoord c1 = worldToChunk(max);
+    BlockAccessor accessor = blockAccessor(min);
+    for (int cy = c0.y; cy <= c1.y; ++cy) {
+        for (int cz = c0.z; cz <= c1.z; ++cz) {
+            for (int cx = c0.x; cx <= c1.x; ++cx) {
+                const Chunk* chunk = accessor.chunkAt(glm::ivec3(cx * Chunk::SIZE, cy * Chunk::HEIGHT, cz * Chunk::SIZE));
+                if (!chunk) {
+                    continue;
+                }
+                glm::ivec3 origin = chunk->worldOrigin();
+                if (!chunk->isRangeEmpty(min - origin, max - origin, kind)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// memoryStats: 遍历已加载与空闲的 chunk 汇总体素、固定开销与 GPU 缓冲字节数
+MemoryStats World::memoryStats() const {
+    MemoryStats stats;
+    chunks_.forEach([&](const Chunk& chunk) {
+        stats.voxelBytes += chunk.storageBytes();
+        stats.chunkMetaBytes += chunk.metadataBytes();
+        stats.meshGpuBytes += chunk.meshGpuBytes();
+        stats.meshScratchBytes = std::max(stats.meshScratchBytes, chunk.meshScratchBytes());
+    });
+    // 各工作线程的临时缓冲按构建结果里见过的最大值估计，加上待复用的输出数组
+    stats.meshScratchBytes *= meshWorkers_.threadCount();
+    {
+        std::lock_guard<std::mutex> lock(meshResultsMutex_);
+        for (const ChunkMeshData& mesh : spareMeshes_) {
+            stats.meshScratchBytes += mesh.capacityBytes();
+        }
+    }
+    chunkPool_.forEachFree([&](const Chunk& chunk) {
+        stats.poolBytes += chunk.storageBytes() + chunk.metadataBytes();
+        stats.poolGpuBytes += chunk.meshGpuBytes();
+    });
+    stats.quadIndexGpuBytes = quadIndices_.gpuBytes();
+    stats.biomeTintGpuBytes = biomeTints_.gpuBytes();
+    stats.cacheBytes = chunkCache_.stats().bytes;
+    stats.animalBytes = animals_.capacity() * sizeof(Animal);
+    stats.meshQueueBytes = meshQueue_.memoryBytes() + meshInputBytesInFlight_;
+    return stats;
 }
 
 // cloudOffset / cloudTime: 提供给渲染模块的云层偏移和时间
@@ -717,353 +840,260 @@ float World::cloudTime() const {
 
 // findChunk: 返回指向已加载 chunk 的裸指针，若不存在则返回 nullptr
 Chunk* World::findChunk(const ChunkCoord& coord) {
-    auto it = chunks_.find(coord);
-    if (it == chunks_.end()) {
-        return nullptr;
-    }
-    return it->second.get();
+    return chunks_.find(coord);
 }
 
 const Chunk* World::findChunk(const ChunkCoord& coord) const {
-    auto it = chunks_.find(coord);
-    if (it == chunks_.end()) {
-        return nullptr;
-    }
-    return it->second.get();
+    return chunks_.find(coord);
 }
 
 // ensureChunksAround: 根据相机位置加载一定范围内的 chunk
-// cameraPos: 世界空间相机位置，使用其 x/z 分量计算中心 chunk
+// cameraPos: 世界空间相机位置，整列模式使用其 x/z 分量计算中心 chunk，立方模式还要加上 y
 void World::ensureChunksAround(const glm::vec3& cameraPos) {
-    ChunkCoord center = worldToChunk(static_cast<int>(std::floor(cameraPos.x)), static_cast<int>(std::floor(cameraPos.z)));
-    for (int dz = -renderDistance_; dz <= renderDistance_; ++dz) {
-        for (int dx = -renderDistance_; dx <= renderDistance_; ++dx) {
-            ChunkCoord coord{center.x + dx, center.z + dz};
-            if (chunks_.find(coord) != chunks_.end()) {
-                continue;
+    ChunkCoord center = worldToChunk(glm::ivec3(glm::floor(cameraPos)));
+    const int verticalRadius = verticalRenderDistance();
+    for (int dy = -verticalRadius; dy <= verticalRadius; ++dy) {
+        for (int dz = -renderDistance_; dz <= renderDistance_; ++dz) {
+            for (int dx = -renderDistance_; dx <= renderDistance_; ++dx) {
+                // 按圆形（立方模式为球形）而非方形范围加载，四角的 chunk 本来就在雾里，省下约 1/5 的 chunk
+                if (!withinRadius(dx, dy, dz, renderDistance_, verticalRadius)) {
+                    continue;
+                }
+                ChunkCoord coord{center.x + dx, center.z + dz, center.y + dy};
+                if (chunks_.find(coord)) {
+                    continue;
+                }
+                auto chunk = chunkPool_.acquire(coord, registry_);
+                // 先尝试从冷缓存解压（保留玩家修改）；动物在首次生成时已经放出，命中时不再重复生成
+                if (!chunkCache_.restore(*chunk)) {
+                    // 在未加载的 chunk 中生成地形与植被
+                    terrain_.generate(*chunk);
+                    // 在该 chunk 中生成一些动物（猪/牛/羊）
+                    spawnAnimalsForChunk(*chunk);
+                }
+                // 生物群系颜色只取决于种子与水平位置，缓存命中时同样重新计算
+                // （立方模式下同一列的每个 chunk 各算一次，结果相同）
+                biomeTints_.update(coord, seed_);
+                // 新 chunk 直接按当前距离选 LOD，不先构建一遍逐体素网格
+                chunk->setLod(lodFor(coord, Chunk::MAX_LOD));
+                meshQueue_.push(coord, MeshScheduler::Priority::Normal); // 标记需要构建 mesh
+                Chunk* loaded = chunk.get();
+                // 槽位中若残留窗口外的旧 chunk，会被顶替出来（先断开它的邻居链接，再链接新 chunk）
+                retireChunk(chunks_.insert(std::move(chunk)));
+                linkNeighbors(*loaded);
             }
-            auto chunk = std::make_unique<Chunk>(coord);
-            // generateTerrain: 在未加载的 chunk 中生成地形与植被
-            generateTerrain(*chunk);
-            // 在该 chunk 中生成一些动物（猪/牛/羊）
-            spawnAnimalsForChunk(*chunk);
-            meshQueue_.push_back(coord); // 标记需要构建 mesh
-            chunks_.emplace(coord, std::move(chunk));
         }
     }
 }
 
-// rebuildMeshes: 每帧处理一定数量的 meshQueue_ 项，避免一帧内阻塞过久
-// maxPerFrame: 最大处理数量（默认值在声明中），built 用于计数
-void World::rebuildMeshes(int maxPerFrame) {
-    int built = 0;
-    while (!meshQueue_.empty() && built < maxPerFrame) {
-        ChunkCoord coord = meshQueue_.front();
-        meshQueue_.pop_front();
+int World::lodFor(ChunkCoord coord, int current) const {
+    const glm::vec2 center((static_cast<float>(coord.x) + 0.5f) * Chunk::SIZE, (static_cast<float>(coord.z) + 0.5f) * Chunk::SIZE);
+    // 立方模式下 LOD 随三维距离变化，头顶和脚下远处的 chunk 同样变粗
+    const float dy = Chunk::CUBIC ? cameraPos_.y - (static_cast<float>(coord.y) + 0.5f) * Chunk::HEIGHT : 0.0f;
+    const float horizontal = glm::length2(glm::vec2(cameraPos_.x, cameraPos_.z) - center);
+    const float distance = std::sqrt(horizontal + dy * dy) / static_cast<float>(Chunk::SIZE);
+    // finer: 不计滞后时应有的级别；coarser: 只有越过半径 + 滞后才降到的级别
+    int finer = 0;
+    int coarser = 0;
+    for (float radius : kLodRadii) {
+        finer += distance > radius ? 1 : 0;
+        coarser += distance > radius + kLodHysteresis ? 1 : 0;
+    }
+    return std::clamp(current, coarser, finer);
+}
+
+// updateLods: 为每个已加载 chunk 重新选 LOD；级别变化会把整个 chunk 标脏并排入重建队列，
+// 新网格上传前继续绘制旧级别的网格。
+// 快照把 LOD 大于 0 的相邻 chunk 边界当作空气（接缝两侧都保留边界面），
+// 所以在 0 与非 0 之间切换时，四个（立方模式六个）共面相邻 chunk 的边界面也要重建；接缝可达整列高度，整个标脏
+void World::updateLods() {
+    chunks_.forEach([&](Chunk& chunk) {
+        const int lod = lodFor(chunk.coord(), chunk.lod());
+        if (lod == chunk.lod()) {
+            return;
+        }
+        const bool coarseChanged = (lod > 0) != (chunk.lod() > 0);
+        chunk.setLod(lod);
+        meshQueue_.push(chunk.coord(), MeshScheduler::Priority::Normal);
+        if (!coarseChanged) {
+            return;
+        }
+        // 整列模式下 dy 不为 0 的两项没有邻居（neighbor 返回 nullptr）
+        static constexpr int kFaces[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}};
+        for (const auto& face : kFaces) {
+            Chunk* neighbor = chunk.neighbor(face[0], face[1], face[2]);
+            if (neighbor) {
+                neighbor->markDirty();
+                meshQueue_.push(neighbor->coord(), MeshScheduler::Priority::Normal);
+            }
+        }
+    });
+}
+
+std::array<int, Chunk::MAX_LOD + 1> World::lodChunkCounts() const {
+    std::array<int, Chunk::MAX_LOD + 1> counts{};
+    chunks_.forEach([&](const Chunk& chunk) { ++counts[static_cast<std::size_t>(chunk.lod())]; });
+    return counts;
+}
+
+// rebuildMeshes: 先上传已完成的 mesh，再按优先级把 meshQueue_ 中的 dirty chunk 拍快照派发给工作线程。
+// 拍快照占用主线程，每帧以 kMeshDispatchBudgetMs 为限；普通任务的在途数还有上限，编辑触发的任务不受限。
+// 剩余的留在队列里等下一帧；快照与上传都在主线程，工作线程只做纯 CPU 的网格构建
+void World::rebuildMeshes() {
+    uploadFinishedMeshes();
+    if (meshQueue_.empty()) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const std::size_t maxInFlight = meshWorkers_.threadCount() * kMeshJobsPerWorker;
+    const ChunkCoord center = worldToChunk(glm::ivec3(glm::floor(cameraPos_)));
+    bool dispatched = false;
+    for (ChunkCoord coord : meshQueue_.ordered(center, viewFrustum_ ? &*viewFrustum_ : nullptr)) {
         Chunk* chunk = findChunk(coord);
         if (!chunk || !chunk->dirty()) {
+            meshQueue_.erase(coord);
             continue;
         }
-        // sampler: 提供给 Chunk::buildMesh 的函数，用于按世界位置采样方块 id
-        auto sampler = [this](const glm::ivec3& pos) { return blockAt(pos); };
-        // tintSampler: 给方块提供基于生物群系的 tint（颜色）采样器
-        auto tintSampler = [this](const glm::vec3& pos, BlockId id, int face) {
-            return sampleTint(pos, id, face);
-        };
-        chunk->buildMesh(registry_, sampler, tintSampler);
-        ++built;
+        if (chunk->meshPending()) {
+            // 等在途结果上传后再派发；保留这一项，编辑的优先级与入队时间不会丢
+            continue;
+        }
+        const bool edit = meshQueue_.priority(coord) == MeshScheduler::Priority::Edit;
+        if (dispatched && std::chrono::duration<double, std::milli>(Clock::now() - start).count() > kMeshDispatchBudgetMs) {
+            break;
+        }
+        if (!edit && meshJobsInFlight_ >= maxInFlight) {
+            // 队列已按优先级排好，后面不会再有编辑项
+            break;
+        }
+        meshQueue_.erase(coord);
+        // 快照包含一格邻居边框，工作线程不再回调 World；
+        // 只重建脏分段，编辑一个方块通常只涉及一两个 16³ 分段
+        const Chunk::SectionMask sections = chunk->takeDirtySections();
+        auto input = std::make_shared<MeshInput>(*chunk, sections);
+        chunk->setMeshPending(true);
+        ++meshJobsInFlight_;
+        meshInputBytesInFlight_ += input->memoryBytes();
+        dispatched = true;
+        meshWorkers_.submit([this, input] {
+            // 复用一份上传完的输出，它的顶点数组容量已经够大时，构建过程不再分配内存
+            ChunkMeshData mesh;
+            {
+                std::lock_guard<std::mutex> lock(meshResultsMutex_);
+                if (!spareMeshes_.empty()) {
+                    mesh = std::move(spareMeshes_.back());
+                    spareMeshes_.pop_back();
+                }
+            }
+            buildChunkMesh(*input, registry_, mesh);
+            std::lock_guard<std::mutex> lock(meshResultsMutex_);
+            meshResults_.push_back(MeshResult{input->coord(), input->revision(), input->memoryBytes(), std::move(mesh)});
+        });
     }
 }
 
-// cleanupChunks: 卸载距离相机过远的 chunk，避免占用过多内存
-void World::cleanupChunks(const glm::vec3& cameraPos) {
-    ChunkCoord center = worldToChunk(static_cast<int>(std::floor(cameraPos.x)), static_cast<int>(std::floor(cameraPos.z)));
-    std::vector<ChunkCoord> toRemove;
-    int limit = renderDistance_ + 2;
-    for (const auto& [coord, chunk] : chunks_) {
-        int dx = coord.x - center.x;
-        int dz = coord.z - center.z;
-        if (std::abs(dx) > limit || std::abs(dz) > limit) {
-            toRemove.push_back(coord);
+// uploadFinishedMeshes: 取走工作线程的结果并上传到 GPU，超过 kMeshUploadBudgetMs 后剩下的留到下一帧
+void World::uploadFinishedMeshes() {
+    std::vector<MeshResult> finished;
+    {
+        std::lock_guard<std::mutex> lock(meshResultsMutex_);
+        finished.swap(meshResults_);
+    }
+    if (finished.empty()) {
+        return;
+    }
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    std::size_t next = 0;
+    for (; next < finished.size(); ++next) {
+        if (next > 0 && std::chrono::duration<double, std::milli>(Clock::now() - start).count() > kMeshUploadBudgetMs) {
+            break;
+        }
+        MeshResult& result = finished[next];
+        --meshJobsInFlight_;
+        meshInputBytesInFlight_ -= result.inputBytes;
+        ++meshBuildStats_.builds;
+        meshBuildStats_.allocations += result.mesh.allocations;
+        meshBuildStats_.lastAllocations = result.mesh.allocations;
+        // 任务在途时 chunk 可能已被卸载（或回收给了别的坐标），结果直接丢弃
+        Chunk* chunk = findChunk(result.coord);
+        if (!chunk || !chunk->meshPending()) {
+            continue;
+        }
+        chunk->setMeshPending(false);
+        chunk->applyMesh(result.mesh, result.revision, quadIndices_);
+        if (chunk->dirty()) {
+            // 构建期间又被修改过，重新排队（若编辑时已入队则保留其优先级）
+            meshQueue_.push(result.coord, MeshScheduler::Priority::Normal);
         }
     }
-    for (const auto& coord : toRemove) {
-        chunks_.erase(coord);
+    // 处理过的输出（包括被丢弃的）交回给工作线程复用
+    const std::size_t maxSpare = meshWorkers_.threadCount() * kMeshJobsPerWorker;
+    std::lock_guard<std::mutex> lock(meshResultsMutex_);
+    for (std::size_t i = 0; i < next && spareMeshes_.size() < maxSpare; ++i) {
+        spareMeshes_.push_back(std::move(finished[i].mesh));
+    }
+    if (next < finished.size()) {
+        meshResults_.insert(meshResults_.end(),
+                            std::make_move_iterator(finished.begin() + static_cast<std::ptrdiff_t>(next)),
+                            std::make_move_iterator(finished.end()));
     }
 }
 
-// generateTerrain: 在指定 chunk 上生成地形高度、表面方块、水线、树木与花等
-void World::generateTerrain(Chunk& chunk) {
-    glm::ivec3 origin = chunk.worldOrigin(); // chunk 在世界坐标系的左下角（最小 x,z）位置
-
-    // 先生成地形（高度图），再生成植被。
-    // 这样可以：
-    // 1) 避免树的间距过滤受 (x,z) 扫描顺序影响而偏向同一角落
-    // 2) 让“边界预留”与树冠半径保持一致，避免树总是缺一半
-    std::array<std::array<int, Chunk::SIZE>, Chunk::SIZE> heights{};
-    std::array<std::array<BiomeType, Chunk::SIZE>, Chunk::SIZE> biomes{};
-
-    for (int z = 0; z < Chunk::SIZE; ++z) {
-        for (int x = 0; x < Chunk::SIZE; ++x) {
-            int worldX = origin.x + x;
-            int worldZ = origin.z + z;
-            // 使用 seed 作为 Z 轴，避免 x/z 坐标数值过大导致浮点精度丢失
-            glm::vec3 uv = glm::vec3(worldX * 0.002f, worldZ * 0.002f, seed_ * 0.1337f);
-            
-            // 1. Biome Factors: Temperature & Humidity
-            float tempNoise = fbm(uv * 0.5f, 2, 2.0f, 0.5f); // Low freq
-            float humidNoise = fbm(uv * 0.5f + glm::vec3(123.4f), 2, 2.0f, 0.5f);
-            
-            // 2. Continentalness / Base Height
-            // Using larger scale noise for continents/mountains
-            float continental = fbm(uv * 0.3f, 3, 2.0f, 0.5f);
-            
-            // Determine Biome
-            BiomeType biome = getBiome(tempNoise, humidNoise, continental);
-            biomes[z][x] = biome;
-
-            // 3. Height Shaping based on Biome
-            
-            // 连续地形参数计算（基于大陆性噪声），消除群系间的断层
-            float baseHeight = 35.0f + continental * 10.0f; // 基础高度随大陆性线性变化
-            float amp = 6.0f; // 基础起伏
-
-            // 山地隆起：当 continental > 0.3 时开始抬升
-            if (continental > 0.3f) {
-                float t = (continental - 0.3f); 
-                baseHeight += t * 60.0f; // 最大增加约 40-50
-                amp += t * 60.0f;        // 山地起伏增大
-            } 
-            // 海洋下沉：当 continental < -0.1 时加速下降
-            else if (continental < -0.1f) {
-                float t = -(continental + 0.1f);
-                baseHeight -= t * 20.0f; // 深海
-            }
+// cleanupChunks: 卸载距离相机过远的 chunk，避免占用过多内存
+void World::cleanupChunks(const glm::vec3& cameraPos) {
+    ChunkCoord center = worldToChunk(glm::ivec3(glm::floor(cameraPos)));
+    const int limit = renderDistance_ + kUnloadMargin;
+    const int verticalLimit = verticalUnloadRadius(verticalRenderDistance());
+    chunks_.evictIf(
+        [&](const Chunk& chunk) {
+            ChunkCoord coord = chunk.coord();
+            return !withinRadius(coord.x - center.x, coord.y - center.y, coord.z - center.z, limit, verticalLimit);
+        },
+        [&](std::unique_ptr<Chunk> chunk) { retireChunk(std::move(chunk)); });
+}
 
-            // 湿度对地表细节的微调（森林更粗糙）
-            if (humidNoise > 0.2f) {
-                amp += (humidNoise - 0.2f) * 10.0f;
-            }
-            
-            // Canyon/River Noise (Negative vein)
-            float riverNoise = std::abs(fbm(uv * 1.5f, 4, 2.0f, 0.5f));
-            riverNoise = 1.0f - glm::smoothstep(0.02f, 0.1f, riverNoise); // 1.0 inside river, 0.0 outside
-            
-            // Detail noise
-            float detail = fbm(uv * 2.0f, 4, 2.0f, 0.5f);
-            
-            int height = static_cast<int>(baseHeight + detail * amp);
-            
-            // Cut rivers
-            if (riverNoise > 0.0f) {
-                float riverDepth = 10.0f * riverNoise;
-                height = static_cast<int>(height - riverDepth);
-            }
-            // Clamp min heigh to bedrock
-            if (height < 1) height = 1;
-            heights[z][x] = height;
-
-            for (int y = 0; y < Chunk::HEIGHT; ++y) {
-                BlockId id = BlockId::Air;
-                if (y <= height) {
-                    if (y == height) {
-                        // Top Soil Logic
-                        
-                        // 1. Natural Beaches logic:
-                        // Limit beaches to be near sea level AND near the ocean (low continentalness).
-                        // This prevents inland rivers or puddles from becoming sandy beaches everywhere.
-                        bool isBeachLevel = (height >= waterLevel_ - 2 && height <= waterLevel_ + 3);
-                        bool isOceanCoast = (continental < 0.01f); // Threshold for coastlines
-
-                        // 2. Biome specific overrides
-                        if (biome == BiomeType::Desert) {
-                            id = BlockId::Sand;
-                        } else if (biome == BiomeType::SnowyTundra) {
-                            // Cold areas have snow
-                            id = BlockId::Snow; 
-                        } else if (isBeachLevel && isOceanCoast) {
-                            // Only generate beaches at the actual ocean coast
-                            id = BlockId::Sand;
-                        } else {
-                            // Default to grass for other biomes
-                             id = BlockId::Grass;
-                        }
-
-                        // River bed is sand/gravel?
-                        if (riverNoise > 0.5f && height < waterLevel_) id = BlockId::Gravel;
-                    } else if (y >= height - 3) {
-                        // Sub Soil
-                        if (biome == BiomeType::Desert || biome == BiomeType::Beach) id = BlockId::Sand;
-                        else id = BlockId::Dirt;
-                    } else {
-                        // Stone
-                        id = BlockId::Stone;
-                    }
-                } else if (y <= waterLevel_) {
-                    id = BlockId::Water;
-                    // Winter freezes water?
-                    if (biome == BiomeType::SnowyTundra && y == waterLevel_) id = BlockId::Snow; // Ice ideally
-                }
-                chunk.setBlock(x, y, z, id);
-            }
-            
-            // Snow cap on tall mountains
-            if (height > 90) {
-                chunk.setBlock(x, height, z, BlockId::Snow);
-            }
-        }
+// retireChunk: 卸载的 chunk 先压缩进 chunkCache_，再把对象本身归还给 chunkPool_
+void World::retireChunk(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) {
+        return;
     }
+    unlinkNeighbors(*chunk);
+    chunkCache_.store(*chunk);
+    chunkPool_.release(std::move(chunk));
+}
 
-    // 植被生成：为避免“扫描顺序偏置”，对候选格做确定性打乱。
-    std::vector<std::pair<int, int>> cells;
-    cells.reserve(static_cast<std::size_t>(Chunk::SIZE * Chunk::SIZE));
-    for (int z = 0; z < Chunk::SIZE; ++z) {
-        for (int x = 0; x < Chunk::SIZE; ++x) {
-            cells.emplace_back(x, z);
+// linkNeighbors: 新 chunk 与已加载的 8 邻居（立方模式 26 邻居）互相建立链接
+void World::linkNeighbors(Chunk& chunk) {
+    ChunkCoord coord = chunk.coord();
+    for (int dy = -Chunk::NEIGHBOR_DY; dy <= Chunk::NEIGHBOR_DY; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+                Chunk* other = chunks_.find(ChunkCoord{coord.x + dx, coord.z + dz, coord.y + dy});
+                chunk.setNeighbor(dx, dy, dz, other);
+                if (other) {
+                    other->setNeighbor(-dx, -dy, -dz, &chunk);
+                }
+            }
         }
     }
-    // 基于 chunk 坐标的确定性 Fisher–Yates shuffle
-    for (int i = static_cast<int>(cells.size()) - 1; i > 0; --i) {
-        float r = noiseRand(origin.x, origin.z, 4200 + i);
-        int j = static_cast<int>(r * static_cast<float>(i + 1));
-        if (j < 0) j = 0;
-        if (j > i) j = i;
-        std::swap(cells[static_cast<std::size_t>(i)], cells[static_cast<std::size_t>(j)]);
-    }
+}
 
-    const int spacing = 7; // 树之间的最小间距（方形邻域半径）
-    const int margin = kOakCanopyRadius; // 确保树冠不会越出 chunk
-
-    for (const auto& cell : cells) {
-        int x = cell.first;
-        int z = cell.second;
-        int height = heights[z][x];
-        int worldX = origin.x + x;
-        int worldZ = origin.z + z;
-        BiomeType biome = biomes[z][x];
-
-        // 树：水面以上才生成
-        if (height > waterLevel_ + 2) {
-            // 预留足够边界，避免树冠跨出 chunk 被裁切
-            bool inside = (x >= margin && x < Chunk::SIZE - margin && z >= margin && z < Chunk::SIZE - margin);
-            if (inside && (biome == BiomeType::Forest || biome == BiomeType::Plains || biome == BiomeType::Swamp || biome == BiomeType::SnowyTundra)) {
-                
-                // Determine Tree Density Map
-                float treeMask = glm::perlin(glm::vec3(worldX * 0.005f, worldZ * 0.005f, seed_ * 0.1337f));
-                float baseProb = 0.01f; 
-                if (biome == BiomeType::Forest) baseProb = 0.12f; // Increased significantly for dense forests
-                else if (biome == BiomeType::Plains) baseProb = 0.005f;
-                
-                float treeProb = glm::mix(baseProb * 0.1f, baseProb * 2.0f, treeMask * 0.5f + 0.5f);
-                
-                // Use pure white noise for placement to avoid grid artifacts
-                bool treeChance = noiseRand(worldX, worldZ, 911) < treeProb;
-
-                if (treeChance) {
-                    bool hasNeighborTree = false;
-                    // Check radius (smaller radius for forests allows denser packing)
-                    int checkR = (biome == BiomeType::Forest) ? 3 : 6;
-                    int y0 = height + 1;
-                    int y1 = glm::min(height + 10, Chunk::HEIGHT - 1);
-                    for (int dz = -checkR; dz <= checkR && !hasNeighborTree; ++dz) {
-                        for (int dx = -checkR; dx <= checkR && !hasNeighborTree; ++dx) {
-                            if (dx == 0 && dz == 0) continue;
-                            int nx = x + dx;
-                            int nz = z + dz;
-                            if (nx < 0 || nx >= Chunk::SIZE || nz < 0 || nz >= Chunk::SIZE) continue;
-                           
-                            // Simple check: Look for logic or leaves?
-                            // Actually current chunk modification is strict. 
-                            // Blocks set in previous loop.
-                            // But here we set blocks.
-                            // Checking `chunk.block` only reads what we just wrote?
-                            // No, `chunk` already has terrain filled.
-                            // We need to check if we placed a tree nearby in THIS loop?
-                            // But `chunk` is being modified.
-                            for (int y = y0; y <= y1; ++y) {
-                                BlockId neighbor = chunk.block(nx, y, nz);
-                                if (neighbor == BlockId::OakLog) {
-                                    hasNeighborTree = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                    if (!hasNeighborTree) {
-                        growTree(chunk, x, z, worldX, worldZ, height);
-                        continue; // Tree takes spot
-                    }
+// unlinkNeighbors: chunk 离开网格前清掉邻居指向它的链接，避免悬空指针
+void World::unlinkNeighbors(Chunk& chunk) {
+    for (int dy = -Chunk::NEIGHBOR_DY; dy <= Chunk::NEIGHBOR_DY; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+                if (Chunk* other = chunk.neighbor(dx, dy, dz)) {
+                    other->setNeighbor(-dx, -dy, -dz, nullptr);
                 }
+                chunk.setNeighbor(dx, dy, dz, nullptr);
             }
         }
-
-        // --- Vegetation (Flowers / Grass) ---
-        // Requirement: "Interweaved random growth", not "patches".
-        // Implementation:
-        // 1. Use a low-freq noise to determine "Patch Density" (Is this a lush area?)
-        // 2. Use high-freq white noise to determine "Placement" (Individual plant)
-        // 3. Use another white noise to determine "Type" (Flower A vs Flower B)
-        
-        if (height > waterLevel_ + 1 && chunk.block(x, height + 1, z) == BlockId::Air) {
-             BlockId soil = chunk.block(x, height, z);
-             // Logic based on biome
-             if (biome == BiomeType::Desert && soil == BlockId::Sand) {
-                 if (noiseRand(worldX, worldZ, 777) < 0.005f) {
-                     chunk.setBlock(x, height+1, z, BlockId::Cactus);
-                     // Add logic for taller cactus?
-                 } else if (noiseRand(worldX, worldZ, 778) < 0.01f) {
-                    chunk.setBlock(x, height+1, z, BlockId::DeadBush);
-                 }
-             }
-             else if (soil == BlockId::Grass) { // Plains, Forest, Mountains
-                 float lushNoise = glm::perlin(glm::vec3(worldX * 0.05f, worldZ * 0.05f, seed_ * 0.1337f));  // Medium freq
-                 float lushFactor = lushNoise * 0.5f + 0.5f; // 0..1
-                 
-                 // Biome multiplier
-                 float density = 0.05f; // Base density
-                 if (biome == BiomeType::Forest) density = 0.15f; // Grassier
-                 if (biome == BiomeType::Plains) density = 0.3f;  // Very grassy/flowery
-                 
-                 // Local density modification
-                 float prob = density * lushFactor;
-                 
-                 // Roll for plant
-                 if (noiseRand(worldX, worldZ, 333) < prob) {
-                     // Pick Type: Grass or Flower?
-                     // 70% Grass, 30% Flower in Plains. 90% Grass in Forest.
-                     float flowerRatio = (biome == BiomeType::Plains) ? 0.3f : 0.05f;
-                     
-                     if (noiseRand(worldX, worldZ, 444) < flowerRatio) {
-                         // Pick specific flower (Interweaved mix)
-                         float typeR = noiseRand(worldX, worldZ, 555);
-                         BlockId flower = BlockId::Flower; // Poppy default
-                         
-                         // Palette: Poppy, Dandelion, AzureBluet, Tulips, etc.
-                         // Weighted selection
-                         if (typeR < 0.2f) flower = BlockId::Dandelion;
-                         else if (typeR < 0.3f) flower = BlockId::Flower; // Poppy
-                         else if (typeR < 0.4f) flower = BlockId::AzureBluet;
-                         else if (typeR < 0.5f) flower = BlockId::RedTulip;
-                         else if (typeR < 0.6f) flower = BlockId::OrangeTulip;
-                         else if (typeR < 0.7f) flower = BlockId::WhiteTulip;
-                         else if (typeR < 0.8f) flower = BlockId::PinkTulip;
-                         else if (typeR < 0.9f) flower = BlockId::OxeyeDaisy;
-                         else flower = BlockId::Cornflower;
-                         
-                         // Rare chance for rare flowers
-                         if (noiseRand(worldX, worldZ, 666) < 0.01f) {
-                             flower = BlockId::LilyOfTheValley;
-                         }
-                         if (biome == BiomeType::Swamp && typeR < 0.5f) flower = BlockId::BlueOrchid;
-
-                         chunk.setBlock(x, height+1, z, flower);
-                     } else {
-                         // Tall Grass
-                         chunk.setBlock(x, height+1, z, BlockId::TallGrass);
-                     }
-                 }
-             }
-        }
     }
 }
 
@@ -1089,21 +1119,19 @@ void World::spawnAnimalsForChunk(const Chunk& chunk) {
         int localX = 2 + static_cast<int>(rx * (Chunk::SIZE - 4));
         int localZ = 2 + static_cast<int>(rz * (Chunk::SIZE - 4));
 
-        // 向下扫描找到地面高度（忽略空气和水）
-        int groundY = -1;
-        for (int y = Chunk::HEIGHT - 2; y >= 1; --y) {
-            BlockId id = chunk.block(localX, y, localZ);
-            if (id != BlockId::Air && id != BlockId::Water) {
-                groundY = y;
-                break;
-            }
+        // 地面高度直接取 chunk 维护的高度图（最高的实心方块，水和花草不计）
+        // 立方模式下整块位于地表之上的 chunk 没有实心方块，由地表所在的 chunk 生成动物
+        int localY = chunk.surfaceHeight(localX, localZ);
+        if (localY < 0) {
+            continue;
         }
+        int groundY = origin.y + localY;
         if (groundY <= waterLevel_ + 1) {
             continue; // 水面附近不生成
         }
 
         // 仅允许在草方块上生成（禁止在树木、岩石、沙子上生成）
-        if (chunk.block(localX, groundY, localZ) != BlockId::Grass) {
+        if (chunk.block(localX, localY, localZ) != BlockId::Grass) {
             continue;
         }
 
@@ -1134,64 +1162,10 @@ void World::spawnAnimalsForChunk(const Chunk& chunk) {
     }
 }
 
-// biomeColor: 根据世界位置计算生物群系颜色（用于草/叶的染色）
-// worldPos: 世界空间位置（通常取方块中心）
-glm::vec3 World::biomeColor(const glm::vec3& worldPos) const {
-    // 使用 3D 坐标来引入种子，避免直接在 2D 坐标上加大数值种子导致精度丢失
-    glm::vec3 pos = glm::vec3(worldPos.x * 0.0022f, worldPos.z * 0.0022f, seed_ * 0.1337f);
-    
-    // perlin 3D
-    float temperature = glm::clamp(glm::perlin(pos * 0.8f + 13.7f) * 0.5f + 0.5f, 0.0f, 1.0f);
-    float moisture = glm::clamp(glm::perlin(pos * 1.4f - 17.3f) * 0.5f + 0.5f, 0.0f, 1.0f);
-    float elevation = glm::clamp(worldPos.y / 120.0f, 0.0f, 1.0f);
-
-    // 各类基色，用于混合出不同生物群系的草地颜色（使用更接近原版的颜色）
-    // 为了在经过 ToneMapping 和 Gamma 校正后呈现 RGB(107, 151, 71)，输入值需要显著降低
-    glm::vec3 plains(38.0f / 255.0f, 97.0f / 255.0f, 15.0f / 255.0f); 
-    glm::vec3 desert(0.93f, 0.86f, 0.52f);    // 沙漠/热带草原黄
-    glm::vec3 swamp(0.28f, 0.32f, 0.22f);     // 沼泽暗绿
-    glm::vec3 mountain(0.6f, 0.65f, 0.55f);   // 山地/冷色调
-
-    // 先基于湿度混合出基础绿色（从平原到沼泽）
-    glm::vec3 baseColor = glm::mix(plains, swamp, glm::smoothstep(0.4f, 0.8f, moisture));
-    // 基于温度混合沙漠色
-    baseColor = glm::mix(baseColor, desert, glm::smoothstep(0.5f, 0.9f, temperature));
-    // 最后基于海拔混合山地色
-    baseColor = glm::mix(baseColor, mountain, glm::smoothstep(0.5f, 0.9f, elevation));
-
-    return glm::clamp(baseColor, glm::vec3(0.0f), glm::vec3(1.0f));
-}
-
-// sampleTint: 根据方块信息和世界位置返回最终的 tint（顶点颜色乘积）
-// worldPos: 用于采样生物群系颜色（如果 info.biomeTint 为 true）
-// info.tint: BlockInfo 中存储的基础 tint（可被生物群系调制）
-glm::vec3 World::sampleTint(const glm::vec3& worldPos, BlockId id, int face) const {
-    const BlockInfo& info = registry_.info(id);
-    glm::vec3 base = info.tint;
-
-    if (id == BlockId::Grass) {
-        if (face == 2) { // Top Face
-            // 使用纯生物群系颜色，不乘基础 tint，以保证颜色准确
-            return biomeColor(worldPos);
-        } else { // Sides (0,1,4,5) and Bottom (3)
-            // 强制使用泥土颜色 (#866043 -> 134, 96, 67)
-            return glm::vec3(0.525f, 0.376f, 0.263f);
-        }
-    }
-
-    if (info.biomeTint) {
-        base *= biomeColor(worldPos);
-    }
-    return base;
-}
-
 // noiseRand / gaussian01: 用于随机性与高斯随机生成，辅助植被/地形
 float World::noiseRand(int x, int z, int salt) const {
-    // Integer hash to avoid floating point precision issues with large seeds
-    unsigned int h = (unsigned int)x * 374761393U + (unsigned int)z * 668265263U + (unsigned int)seed_ + (unsigned int)salt;
-    h = (h ^ (h >> 13)) * 1274126177U;
-    h = h ^ (h >> 16);
-    return (h & 0x7FFFFFFF) / 2147483647.0f;
+    // 与地形生成共用同一个哈希，保证动物与植被的随机序列一致
+    return terrain_.noiseRand(x, z, salt);
 }
 
 float World::gaussian01(int x, int z, int salt) const {
@@ -1250,14 +1224,15 @@ void World::updateAnimals(float dt) {
             int bx = static_cast<int>(std::floor(p.x));
             int bz = static_cast<int>(std::floor(p.z));
             int by = static_cast<int>(std::floor(p.y));
-            if (by <= 1 || by >= Chunk::HEIGHT) return false;
+            if (!Chunk::CUBIC && (by <= 1 || by >= Chunk::HEIGHT)) return false;
 
-            BlockId below = blockAt(glm::ivec3(bx, by - 1, bz));
-            BlockId at    = blockAt(glm::ivec3(bx, by, bz));
+            glm::ivec3 below(bx, by - 1, bz);
+            glm::ivec3 at(bx, by, bz);
 
-            if (below == BlockId::Air || below == BlockId::Water) return false;
-            if (at != BlockId::Air && at != BlockId::TallGrass && at != BlockId::Flower) return false;
-            return true;
+            // 脚下必须是实心方块；身位不能是实心方块或水（花草可以穿过）
+            if (isRangeEmpty(below, below, Chunk::Occupancy::Solid)) return false;
+            if (!isRangeEmpty(at, at, Chunk::Occupancy::Solid)) return false;
+            return blockAt(at) != BlockId::Water;
         };
 
         if (canStandAt(newPos)) {
@@ -1352,167 +1327,64 @@ void World::renderAnimals(const Shader& shader) const {
     shader.setMat4("uModel", glm::mat4(1.0f));
 }
 
-// growTree: 在指定位置生成树干与树冠（简单体素树）
-// 参数说明见函数签名：chunk（目标 chunk），localX/localZ（chunk 局部 x/z），
-// worldX/worldZ（世界 x/z，用于随机函数），groundHeight（地表高度）
-void World::growTree(Chunk& chunk, int localX, int localZ, int worldX, int worldZ, int groundHeight) {
-    int baseY = groundHeight + 1; 
-    if (baseY + 12 >= Chunk::HEIGHT) return;
-
-    // Deterministic Randomness
-    float rType = noiseRand(worldX, worldZ, 666);
-    float rHeight = noiseRand(worldX, worldZ, 123);
-    
-    // Style distribution:
-    // 0: Classic Oak (Blob) - 40%
-    // 1: Tall / Double Blob - 20%
-    // 2: Pine / Conical - 20%
-    // 3: Wide / Flat - 20%
-    int style = 0;
-    if (rType < 0.40f) style = 0;
-    else if (rType < 0.60f) style = 1;
-    else if (rType < 0.80f) style = 2;
-    else style = 3;
-
-    // Determine Trunk Height
-    int height = 4 + (int)(rHeight * 3.5f); // 4 to 7
-    if (style == 1) height += 2; // Tall trees need more height (6-9)
-    if (style == 2) height += 1; // Pines are slightly taller
-
-    // Helper: Safe Set
-    auto setIfReplaceable = [&](int x, int y, int z, BlockId id) {
-        if (x < 0 || x >= Chunk::SIZE || z < 0 || z >= Chunk::SIZE || y < 0 || y >= Chunk::HEIGHT) return;
-        BlockId current = chunk.block(x, y, z);
-        if (current == BlockId::Air || current == BlockId::TallGrass || current == BlockId::Flower || 
-            current == BlockId::OakLeaves || current == BlockId::Snow || current == BlockId::Water) {
-            chunk.setBlock(x, y, z, id);
-        }
-    };
-
-    // 1. Generate Trunk
-    for (int i = 0; i < height; ++i) {
-        setIfReplaceable(localX, baseY + i, localZ, BlockId::OakLog);
-    }
-
-    int topY = baseY + height - 1;
-
-    // Helper: Draw Leaf Blob
-    auto drawBlob = [&](int cx, int cy, int cz, float radius) {
-        int rCeil = (int)ceil(radius);
-        for (int dy = -rCeil; dy <= rCeil; ++dy) {
-            for (int dx = -rCeil; dx <= rCeil; ++dx) {
-                for (int dz = -rCeil; dz <= rCeil; ++dz) {
-                    float distSq = (float)(dx*dx + dy*dy + dz*dz);
-                    // Add noise to radius to make it organic/irregular
-                    float noise = noiseRand(worldX + dx, worldZ + dz, cy + dy) * 1.5f - 0.75f; 
-                    if (distSq <= (radius + noise) * (radius + noise)) {
-                        setIfReplaceable(cx + dx, cy + dy, cz + dz, BlockId::OakLeaves);
-                    }
-                }
-            }
-        }
-    };
-
-    // 2. Generate Canopy
-    if (style == 0) { 
-        // --- Classic Oak (Irregular Blob) ---
-        drawBlob(localX, topY - 1, localZ, 2.5f);
-    } 
-    else if (style == 1) { 
-        // --- Tall / Double Blob ---
-        drawBlob(localX, topY, localZ, 2.0f);   // Top small blob
-        drawBlob(localX, topY - 3, localZ, 2.8f); // Lower big blob
-    }
-    else if (style == 2) { 
-        // --- Pine / Conical ---
-        // Tip
-        setIfReplaceable(localX, topY + 1, localZ, BlockId::OakLeaves);
-        // Layers
-        int layers = height - 2;
-        for (int i = 0; i < layers; ++i) {
-            int y = topY - i;
-            float progress = (float)i / (float)layers; // 0 (top) to 1 (bottom)
-            int radius = 1 + (int)(progress * 2.5f); // 1 to 3
-            
-            for (int dx = -radius; dx <= radius; ++dx) {
-                for (int dz = -radius; dz <= radius; ++dz) {
-                    if (dx*dx + dz*dz <= radius*radius + 1) {
-                         // Ragged edges: 20% chance to skip block
-                         if (noiseRand(worldX + dx, worldZ + dz, y) > 0.2f)
-                            setIfReplaceable(localX + dx, y, localZ + dz, BlockId::OakLeaves);
-                    }
-                }
-            }
-        }
-    }
-    else { 
-        // --- Wide / Flat ---
-        // 2-3 layers, very wide
-        for (int y = topY - 1; y <= topY + 1; ++y) {
-            int radius = (y == topY) ? 2 : 3;
-            if (y == topY + 1) radius = 1; // Small top
-            
-            for (int dx = -radius; dx <= radius; ++dx) {
-                for (int dz = -radius; dz <= radius; ++dz) {
-                     float dist = sqrt(dx*dx + dz*dz);
-                     if (dist <= radius + 0.4f) {
-                         setIfReplaceable(localX + dx, y, localZ + dz, BlockId::OakLeaves);
-                     }
-                }
-            }
-        }
-    }
-}
-
 // toLocal: 将世界坐标转换为指定 chunk 的局部坐标（chunk 内索引）
 // pos: 世界坐标，coord: chunk 的 chunk 坐标（以 chunk 为单位的格子位置）
 glm::ivec3 World::toLocal(const glm::ivec3& pos, const ChunkCoord& coord) const {
-    return glm::ivec3(pos.x - coord.x * Chunk::SIZE, pos.y, pos.z - coord.z * Chunk::SIZE);
+    return glm::ivec3(pos.x - coord.x * Chunk::SIZE, pos.y - coord.y * Chunk::HEIGHT, pos.z - coord.z * Chunk::SIZE);
 }
 
-// worldToChunk: 根据世界 x,z 计算它属于哪个 chunk（坐标以 chunk 为单位）
+// worldToChunk: 根据世界坐标计算它属于哪个 chunk（坐标以 chunk 为单位）；整列模式的 y 恒为 0
 // 使用 floorDiv 确保负坐标也正确映射到 chunk 网格
-ChunkCoord World::worldToChunk(int x, int z) const {
-    return ChunkCoord{floorDiv(x, Chunk::SIZE), floorDiv(z, Chunk::SIZE)};
+ChunkCoord World::worldToChunk(const glm::ivec3& pos) const {
+    return ChunkCoord{floorDiv(pos.x, Chunk::SIZE), floorDiv(pos.z, Chunk::SIZE), Chunk::CUBIC ? floorDiv(pos.y, Chunk::HEIGHT) : 0};
 }
 
 // setBlockInternal: 在世界坐标 pos 放置方块 id（处理 chunk 查找、local 转换与 dirty 标记）
 // 返回是否成功（如坐标越界或 chunk 不存在则返回 false）
 bool World::setBlockInternal(const glm::ivec3& pos, BlockId id) {
-    if (pos.y < 0 || pos.y >= Chunk::HEIGHT) {
+    if (!Chunk::inWorldHeight(pos.y)) {
         return false;
     }
-    ChunkCoord coord = worldToChunk(pos.x, pos.z);
+    ChunkCoord coord = worldToChunk(pos);
     Chunk* chunk = findChunk(coord);
     if (!chunk) {
         return false;
     }
     glm::ivec3 local = toLocal(pos, coord);
-    if (chunk->block(local.x, pos.y, local.z) == id) {
+    if (chunk->block(local.x, local.y, local.z) == id) {
         return false;
     }
-    chunk->setBlock(local.x, pos.y, local.z, id);
-    meshQueue_.push_back(coord); // 标记该 chunk 需要重建 mesh
-    markNeighborsDirty(pos);     // 如果位于 chunk 边界，还需标记相邻 chunk
+    chunk->setBlock(local.x, local.y, local.z, id); // 同时把 local.y±1 所在的分段标脏
+    meshQueue_.push(coord, MeshScheduler::Priority::Edit); // 标记该 chunk 需要优先重建 mesh
+    markNeighborsDirty(pos);     // 如果位于 chunk 边界，还需标记相邻 chunk（含对角）
     return true;
 }
 
-// markNeighborsDirty: 如果修改位置位于 chunk 边界，则把相邻 chunk 标记为需要重建
+// markNeighborsDirty: 修改位置周围 3x3x3 范围内方块的可见面与 AO 都可能变化；
+// 该范围跨出 chunk 边界（含对角，立方模式还有上下）时，把相邻 chunk 中对应的分段标记为需要重建
 void World::markNeighborsDirty(const glm::ivec3& pos) {
-    ChunkCoord coord = worldToChunk(pos.x, pos.z);
+    ChunkCoord coord = worldToChunk(pos);
     glm::ivec3 local = toLocal(pos, coord);
-    std::array<std::pair<bool, ChunkCoord>, 4> candidates = {
-        std::make_pair(local.x == 0, ChunkCoord{coord.x - 1, coord.z}),
-        std::make_pair(local.x == Chunk::SIZE - 1, ChunkCoord{coord.x + 1, coord.z}),
-        std::make_pair(local.z == 0, ChunkCoord{coord.x, coord.z - 1}),
-        std::make_pair(local.z == Chunk::SIZE - 1, ChunkCoord{coord.x, coord.z + 1}),
-    };
-    for (const auto& entry : candidates) {
-        if (!entry.first) continue;
-        Chunk* neighbor = findChunk(entry.second);
-        if (!neighbor) continue;
-        neighbor->markDirty();
-        meshQueue_.push_back(entry.second);
+    const int dxMin = local.x == 0 ? -1 : 0;
+    const int dxMax = local.x == Chunk::SIZE - 1 ? 1 : 0;
+    const int dzMin = local.z == 0 ? -1 : 0;
+    const int dzMax = local.z == Chunk::SIZE - 1 ? 1 : 0;
+    const int dyMin = Chunk::CUBIC && local.y == 0 ? -1 : 0;
+    const int dyMax = Chunk::CUBIC && local.y == Chunk::HEIGHT - 1 ? 1 : 0;
+    for (int dy = dyMin; dy <= dyMax; ++dy) {
+        // 在上下相邻的 chunk 里，修改位置的局部 y 要平移一个 chunk 高度
+        const int y = local.y - dy * Chunk::HEIGHT;
+        const Chunk::SectionMask sections = Chunk::sectionsSpanning(y - 1, y + 1);
+        for (int dz = dzMin; dz <= dzMax; ++dz) {
+            for (int dx = dxMin; dx <= dxMax; ++dx) {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+                ChunkCoord other{coord.x + dx, coord.z + dz, coord.y + dy};
+                Chunk* neighbor = findChunk(other);
+                if (!neighbor) continue;
+                neighbor->markDirty(sections);
+                meshQueue_.push(other, MeshScheduler::Priority::Edit);
+            }
+        }
     }
 }
 
@@ -1,14 +1,28 @@
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include "block_accessor.h"
+#include "biome_tint_map.h"
 #include "chunk.h"
+#include "chunk_cache.h"
+#include "chunk_grid.h"
+#include "chunk_mesher.h"
+#include "chunk_pool.h"
+#include "frustum.h"
+#include "memory_stats.h"
+#include "mesh_scheduler.h"
 #include "raycast.h"
+#include "terrain_generator.h"
+#include "thread_pool.h"
 
 class Shader;
 class TextureAtlas;
@@ -44,15 +58,37 @@ public:
           const AnimalUVLayout& pigUV,
           const AnimalUVLayout& cowUV,
           const AnimalUVLayout& sheepUV,
-          int seed);
+          int seed,
+          int renderDistance = kDefaultRenderDistance);
     ~World();
 
+    static constexpr int kDefaultRenderDistance = 8;
+    static constexpr int kMaxRenderDistance = 32;
+    // 立方 chunk 模式下 Y 方向的加载半径上限（chunk）：流式范围是以相机为心的球，上下再按此截断
+    static constexpr int kMaxVerticalRenderDistance = 6;
+
     int getSeed() const { return seed_; }
     
     void update(const glm::vec3& cameraPos, float dt);
 
-    void render(const Shader& shader) const;
-    void renderTransparent(const Shader& shader) const;
+    // chunk 用 chunkShader（解码压缩顶点的 chunk.vert / chunk_shadow.vert）绘制，动物用 shader；
+    // 两者的其余 uniform 需由调用方事先设好，每个 chunk 的 uChunkOrigin 在这里设置。
+    // frustum 非空时按 chunk 的收紧包围盒剔除（阴影 pass 改用 renderShadows）；
+    // eye 非空时在 CPU 端跳过各分段中整体背对 eye 的面方向（阴影 pass 剔除正面，不传）
+    void render(const Shader& chunkShader,
+                const Shader& shader,
+                const Frustum* frustum = nullptr,
+                const glm::vec3* eye = nullptr) const;
+    // 阴影 pass：只绘制与光源正交投影体相交的 chunk（lightSpace 只覆盖 detailDistance 内），
+    // 远处 LOD chunk 整块跳过；不更新 drawnChunkCount 等主视角统计
+    void renderShadows(const Shader& chunkShader, const Shader& shader, const glm::mat4& lightSpace) const;
+    // 水面网格，按 chunk 从远到近绘制；在 renderTransparent 之前调用。返回时 chunkShader 仍处于绑定状态
+    void renderLiquids(const Shader& chunkShader, const Frustum* frustum = nullptr) const;
+    // 返回时 chunkShader 仍处于绑定状态
+    void renderTransparent(const Shader& chunkShader, const Frustum* frustum = nullptr) const;
+    // 植物十字面片：每个 chunk 一次实例化绘制（billboardShader 为 billboard.vert + block.frag）。
+    // 片元按 alpha 镂空，在不透明 pass 中绘制；离相机超过 billboardDistance 的 chunk 整块不提交
+    void renderBillboards(const Shader& billboardShader, const Frustum* frustum = nullptr) const;
     void renderChunkBounds(const Shader& shader);
     void renderClouds(const Shader& shader, bool enabled) const;
     void renderSun(const Shader& shader) const;
@@ -63,6 +99,12 @@ public:
     bool placeBlock(const glm::ivec3& pos, BlockId id);
 
     BlockId blockAt(const glm::ivec3& pos) const;
+    // 以 hint 所在 chunk 为起点的访问器，后续相邻读取沿 chunk 链接跳转（射线、碰撞、寻路用）
+    BlockAccessor blockAccessor(const glm::ivec3& hint) const;
+    // 世界坐标闭区间 [min, max] 内是否不含指定种类的方块（未加载的 chunk 视为空）
+    bool isRangeEmpty(const glm::ivec3& min,
+                      const glm::ivec3& max,
+                      Chunk::Occupancy kind = Chunk::Occupancy::Solid) const;
 
     glm::vec3 sunDirection() const { return sunDir_; }
     glm::vec3 sunColor() const { return sunColor_; }
@@ -75,7 +117,38 @@ public:
     float cloudTime() const;
 
     int chunkCount() const { return static_cast<int>(chunks_.size()); }
+    // 填充 World 负责的各项内存统计（纹理图集、阴影贴图由调用方补充）
+    MemoryStats memoryStats() const;
+    // 最近一次带视锥的 render 实际绘制的 chunk 数
+    int drawnChunkCount() const { return drawnChunks_; }
+    // 同一次 render 中视锥内 chunk 的不透明四边形总数，以及跳过背对方向后实际提交的数量
+    std::size_t visibleSolidQuadCount() const { return visibleSolidQuads_; }
+    std::size_t drawnSolidQuadCount() const { return drawnSolidQuads_; }
+    std::size_t animalCount() const { return animals_.size(); }
+    const ChunkPool::Stats& chunkPoolStats() const { return chunkPool_.stats(); }
+    const ChunkCache::Stats& chunkCacheStats() const { return chunkCache_.stats(); }
+    // 待重建队列的深度与最早一项的等待时间（调试面板用）
+    MeshScheduler::Stats meshQueueStats() const { return meshQueue_.stats(); }
+    std::size_t meshJobsInFlight() const { return meshJobsInFlight_; }
+    // 网格构建的堆分配统计（调试面板用）：allocations 为扩容过的缓冲数，稳态下应不再增长
+    struct MeshBuildStats {
+        std::size_t builds = 0;          // 主线程已取回的构建数
+        std::size_t allocations = 0;     // 累计扩容次数
+        std::size_t lastAllocations = 0; // 最近取回的一次构建中的扩容次数
+    };
+    const MeshBuildStats& meshBuildStats() const { return meshBuildStats_; }
+    void setChunkCacheBudget(std::size_t bytes) { chunkCache_.setBudget(bytes); }
     int renderDistance() const { return renderDistance_; }
+    // Y 方向的加载半径（chunk），整列模式为 0
+    int verticalRenderDistance() const {
+        return Chunk::CUBIC ? std::min(renderDistance_, kMaxVerticalRenderDistance) : 0;
+    }
+    // 逐体素网格的半径（方块）：更远的 chunk 使用 LOD 网格，阴影与植物只需覆盖到这里
+    float detailDistance() const {
+        return std::min(kLodRadii[0], static_cast<float>(renderDistance_)) * static_cast<float>(Chunk::SIZE);
+    }
+    // 已加载 chunk 按 LOD 级别的计数（调试面板用）
+    std::array<int, Chunk::MAX_LOD + 1> lodChunkCounts() const;
 
     void setAoStrength(float v) { aoStrength_ = v; }
     float aoStrength() const { return aoStrength_; }
@@ -85,7 +158,28 @@ public:
 
     void setFogDensity(float v) { fogDensity_ = v; }
 
+    // 已加载 chunk 的生物群系颜色（block.frag 的 uBiomeTint），绘制前由调用方绑定
+    const BiomeTintMap& biomeTints() const { return biomeTints_; }
+
+    // 植物的绘制半径（方块，按相机到 chunk 的水平最近距离计）
+    void setBillboardDistance(float v) { billboardDistance_ = v; }
+    float billboardDistance() const { return billboardDistance_; }
+    // 最近一次 renderBillboards 提交的植物实例数
+    std::size_t drawnBillboardCount() const { return drawnBillboards_; }
+
 private:
+    static constexpr std::size_t kDefaultChunkCacheBudget = 32u * 1024u * 1024u;
+    // 每帧用于上传已完成 mesh 的时间预算（至少上传一个）
+    static constexpr double kMeshUploadBudgetMs = 2.0;
+    // 每帧在主线程为派发构建任务拍快照的时间预算（至少派发一个）
+    static constexpr double kMeshDispatchBudgetMs = 1.0;
+    // 每个工作线程最多排队的构建任务数，避免快照占用过多内存（编辑触发的任务不受此限制）
+    static constexpr std::size_t kMeshJobsPerWorker = 4;
+    // LOD 切换半径（chunk）：与相机的水平距离（立方模式为三维距离）超过 kLodRadii[i] 的 chunk 使用 LOD i+1
+    static constexpr std::array<float, Chunk::MAX_LOD> kLodRadii = {8.0f, 14.0f, 22.0f};
+    // 变粗时要多走出的距离（chunk），避免在半径附近来回切换、反复重建
+    static constexpr float kLodHysteresis = 1.0f;
+
     struct CloudLayer;
     struct SunMesh;
     struct AnimalMesh;
@@ -108,13 +202,28 @@ private:
         int wanderStep = 0;        // 随每次换向递增，保证噪声采样不同
     };
 
+    // 工作线程构建完成、等待主线程上传的 mesh
+    struct MeshResult {
+        ChunkCoord coord;
+        std::uint64_t revision = 0;
+        std::size_t inputBytes = 0; // 对应快照的 MeshInput::memoryBytes()
+        ChunkMeshData mesh;
+    };
+
     Chunk* findChunk(const ChunkCoord& coord);
     const Chunk* findChunk(const ChunkCoord& coord) const;
     void updateSun(float dt);
     void ensureChunksAround(const glm::vec3& cameraPos);
-    void rebuildMeshes(int maxPerFrame = 2);
+    void rebuildMeshes();
+    // 按相机距离为 chunk 选 LOD：current 为当前级别，变细立即生效，变粗需越过 kLodHysteresis
+    int lodFor(ChunkCoord coord, int current) const;
+    void updateLods();
+    std::vector<const Chunk*> transparentOrder(const Frustum* frustum) const;
+    void uploadFinishedMeshes();
     void cleanupChunks(const glm::vec3& cameraPos);
-    void generateTerrain(Chunk& chunk);
+    void retireChunk(std::unique_ptr<Chunk> chunk);
+    void linkNeighbors(Chunk& chunk);
+    void unlinkNeighbors(Chunk& chunk);
     void spawnAnimalsForChunk(const Chunk& chunk);
     void updateAnimals(float dt);
     void renderAnimals(const Shader& shader) const;
@@ -122,17 +231,18 @@ private:
 
     bool setBlockInternal(const glm::ivec3& pos, BlockId id);
     glm::ivec3 toLocal(const glm::ivec3& pos, const ChunkCoord& coord) const;
-    ChunkCoord worldToChunk(int x, int z) const;
-    glm::vec3 biomeColor(const glm::vec3& worldPos) const;
-    glm::vec3 sampleTint(const glm::vec3& worldPos, BlockId id, int face) const;
+    ChunkCoord worldToChunk(const glm::ivec3& pos) const;
     float noiseRand(int x, int z, int salt) const;
     float gaussian01(int x, int z, int salt) const;
-    void growTree(Chunk& chunk, int localX, int localZ, int worldX, int worldZ, int groundHeight);
 
     TextureAtlas& atlas_;
     BlockRegistry& registry_;
-    std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>> chunks_;
-    std::deque<ChunkCoord> meshQueue_;
+    QuadIndexBuffer quadIndices_; // 所有 chunk VAO 共用的四边形索引；声明在 chunks_ 之前，析构时最后删除
+    BiomeTintMap biomeTints_;
+    ChunkGrid chunks_;
+    ChunkPool chunkPool_;
+    ChunkCache chunkCache_{kDefaultChunkCacheBudget};
+    MeshScheduler meshQueue_;
     std::unique_ptr<CloudLayer> clouds_;
     std::unique_ptr<SunMesh> sunMesh_;
     std::unique_ptr<AnimalMesh> pigMesh_;
@@ -151,12 +261,29 @@ private:
     float aoStrength_ = 1.0f;
     float shadowStrengthVal_ = 0.3f;
     
-    int renderDistance_ = 8;
+    int renderDistance_ = kDefaultRenderDistance;
+    float billboardDistance_ = 80.0f;
     int seed_ = 12345;
     int waterLevel_ = 32;
+    TerrainGenerator terrain_{seed_, waterLevel_}; // 依赖上面两个成员，声明顺序不能调换
 
     GLuint boundsVao_ = 0;
     GLuint boundsVbo_ = 0;
     std::vector<RenderVertex> boundsVertices_;
     std::vector<Animal> animals_;
+    mutable int drawnChunks_ = 0;
+    mutable std::size_t visibleSolidQuads_ = 0;
+    mutable std::size_t drawnSolidQuads_ = 0;
+    mutable std::size_t drawnBillboards_ = 0;
+    mutable std::optional<Frustum> viewFrustum_; // 最近一次带视锥的 render 所用视锥，用于排定构建顺序
+
+    mutable std::mutex meshResultsMutex_;
+    std::vector<MeshResult> meshResults_; // 由工作线程写入，受 meshResultsMutex_ 保护
+    // 已上传完的输出，工作线程取来复用其数组容量（最多保留在途任务上限那么多），受 meshResultsMutex_ 保护
+    std::vector<ChunkMeshData> spareMeshes_;
+    MeshBuildStats meshBuildStats_;
+    std::size_t meshJobsInFlight_ = 0;     // 已派发但结果尚未被主线程取走的任务数
+    std::size_t meshInputBytesInFlight_ = 0; // 这些任务的输入快照占用的字节数之和
+    // 放在最后：析构时最先 join 工作线程，之后任务引用的成员才会销毁
+    ThreadPool meshWorkers_;
 };